@@ -0,0 +1,110 @@
+// Compares Variant::FromString with the regex parser it replaced, for every scalar type.
+// Built by the VariantFromStringBench project in GusEngine.sln, run it in Release|x64. Outside Visual Studio, build it
+// from the repository root with:
+//   g++ -std=c++20 -O2 -I. benchmarks/variant_from_string.cpp core/types/variant_type.cpp core/types/string_name.cpp utils/logger.cpp core/globals.cpp -o variant_from_string
+#include "core/types/variant_type.h"
+
+#include <chrono>
+#include <cstdio>
+#include <regex>
+#include <string>
+#include <vector>
+
+// The previous implementation of Variant::FromString, kept as it was apart from the name and the 64 bit casts,
+// which are needed where long long is not int64_t.
+static Variant from_string_regex(std::string* str)
+{
+	std::regex pattern (R"(^([A-Za-z]+)(.+);$)");
+	std::smatch match;
+
+	if (!std::regex_search(*str, match, pattern)) {
+		return Variant(Variant::Empty);
+	}
+
+	std::string type = match[1];
+	std::string content = match[2];
+
+	if ((*str).starts_with(";")) {
+		return Variant(Variant::Void);
+	}
+	else if (type == "Bool") {
+		return Variant(content == "1" ? true : false);
+	}
+	else if (type == "Int32") {
+		return Variant(std::stoi(content));
+	}
+	else if (type == "UInt32") {
+		return Variant(static_cast<uint32_t>(std::stoul(content)));
+	}
+	else if (type == "LLong") {
+		return Variant(static_cast<int64_t>(std::stoll(content)));
+	}
+	else if (type == "ULLong") {
+		return Variant(static_cast<uint64_t>(std::stoull(content)));
+	}
+	else if (type == "Float") {
+		return Variant(std::stof(content));
+	}
+	else if (type == "Double") {
+		return Variant(std::stod(content));
+	}
+	else if (type == "String") {
+		content.pop_back();
+		return Variant(content.substr(1));
+	}
+	return Variant(Variant::Empty);
+}
+
+struct BenchCase {
+	const char* name;
+	Variant value;
+	// The form the regex parser reads, where it never understood what StringSerialise writes for the type.
+	const char* legacyForm = nullptr;
+};
+
+template <typename F>
+static double nanoseconds_per_call(const std::string& input, size_t iterations, F parse)
+{
+	std::string str = input;
+	size_t sink = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < iterations; i++) {
+		sink += static_cast<size_t>(parse(str).Type()) + 1;
+	}
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	if (sink == 0) std::puts("");
+	return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+int main()
+{
+	const size_t regexIterations = 200000;
+	const size_t iterations = 5000000;
+	std::vector<BenchCase> cases = {
+		{ "Bool", Variant(true), "Bool1;" },
+		{ "Int32", Variant(int32_t(-123456)) },
+		{ "UInt32", Variant(uint32_t(3000000000u)) },
+		{ "Int64", Variant(int64_t(-9000000000000ll)), "LLong-9000000000000;" },
+		{ "UInt64", Variant(uint64_t(18000000000000000000ull)) },
+		{ "Float", Variant(3.125f) },
+		{ "Double", Variant(-1024.5) },
+		{ "String", Variant("short"), "String\"short\";" },
+		{ "LongString", Variant("a string well past the short string limit"), "String\"a string well past the short string limit\";" },
+	};
+
+	std::printf("%-12s %14s %14s %9s  %s\n", "type", "regex ns/op", "new ns/op", "speedup", "regex result");
+	for (const BenchCase& c : cases) {
+		std::string input = Variant::StringSerialise(c.value) + ";";
+		std::string legacyInput = c.legacyForm != nullptr ? std::string(c.legacyForm) : input;
+		if (!(Variant::FromString(input) == c.value)) {
+			std::printf("%-12s FromString misread '%s'\n", c.name, input.c_str());
+			return 1;
+		}
+		// The regex parser reads Int32 and UInt32 as types "Int" and "UInt", so it is timed failing on those.
+		bool legacyCorrect = from_string_regex(&legacyInput) == c.value;
+		double oldTime = nanoseconds_per_call(legacyInput, regexIterations, [](std::string& s) { return from_string_regex(&s); });
+		double newTime = nanoseconds_per_call(input, iterations, [](std::string& s) { return Variant::FromString(s); });
+		std::printf("%-12s %14.1f %14.1f %8.0fx  %s\n", c.name, oldTime, newTime, oldTime / newTime, legacyCorrect ? "correct" : "Empty");
+	}
+	return 0;
+}
@@ -3,10 +3,28 @@
 #include "types/type_registry.h"
 
 #include "filesystem/engine_io.h"
+#include <charconv>
+#include <string_view>
 
 void Engine::Run(vector<string> args) {
 	engine_type_registry::type_registry::register_all_types();
 	vector<string> files = EngineIO::FileSystem::GetFilesInDir("./", true);
+	for (const string& arg : args) {
+		if (arg.starts_with("--frames-in-flight=")) {
+			std::string_view value = std::string_view(arg).substr(arg.find('=') + 1);
+			uint32_t count = 0;
+			std::from_chars_result result = std::from_chars(value.data(), value.data() + value.size(), count);
+			if (result.ec != std::errc() || result.ptr != value.data() + value.size()) {
+				Log.Warn("Core", "Invalid value for --frames-in-flight '" + string(value) + "', using the default.");
+			}
+			else {
+				_renderer.SetFramesInFlight(count);
+			}
+		}
+		else if (arg == "--bindless") {
+			_renderer.SetBindless(true);
+		}
+	}
 	Init();
 	MainLoop();
 	Cleanup();
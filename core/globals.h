@@ -6,7 +6,7 @@
 extern Logger Log;
 const uint32_t WIDTH = 800;
 const uint32_t HEIGHT = 600;
-constexpr uint64_t VARIANT_ENUM_SIZE = sizeof(short);
+constexpr uint64_t VARIANT_ENUM_SIZE = sizeof(int32_t);
 
 // Helper for enum conversions and casting
 
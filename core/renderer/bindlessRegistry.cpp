@@ -0,0 +1,186 @@
+#include "bindlessRegistry.h"
+#include <algorithm>
+
+BindlessRegistry::BindlessRegistry(vkb::Device* device, const vkb::PhysicalDevice* physicalDevice)
+{
+	_device = *device;
+
+	VkPhysicalDeviceVulkan12Properties properties12{};
+	properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+	VkPhysicalDeviceProperties2 properties{};
+	properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	properties.pNext = &properties12;
+	vkGetPhysicalDeviceProperties2(physicalDevice->physical_device, &properties);
+
+	_arrays[static_cast<uint32_t>(Binding::SampledImages)] = { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, std::min(16384u, properties12.maxDescriptorSetUpdateAfterBindSampledImages) };
+	_arrays[static_cast<uint32_t>(Binding::StorageBuffers)] = { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, std::min(16384u, properties12.maxDescriptorSetUpdateAfterBindStorageBuffers) };
+	_arrays[static_cast<uint32_t>(Binding::Samplers)] = { VK_DESCRIPTOR_TYPE_SAMPLER, std::min(256u, properties12.maxDescriptorSetUpdateAfterBindSamplers) };
+
+	std::vector<VkDescriptorSetLayoutBinding> bindings{};
+	std::vector<VkDescriptorBindingFlags> bindingFlags{};
+	std::vector<VkDescriptorPoolSize> poolSizes{};
+	for (uint32_t i = 0; i < static_cast<uint32_t>(Binding::Count); i++) {
+		VkDescriptorSetLayoutBinding binding{};
+		binding.binding = i;
+		binding.descriptorType = _arrays[i].type;
+		binding.descriptorCount = _arrays[i].capacity;
+		binding.stageFlags = VK_SHADER_STAGE_ALL;
+		bindings.push_back(binding);
+		bindingFlags.push_back(VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT);
+		poolSizes.push_back({ _arrays[i].type, _arrays[i].capacity });
+	}
+
+	VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+	flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+	flagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+	flagsInfo.pBindingFlags = bindingFlags.data();
+
+	VkDescriptorSetLayoutCreateInfo layoutInfo{};
+	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutInfo.pNext = &flagsInfo;
+	layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+	layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+	layoutInfo.pBindings = bindings.data();
+	if (vkCreateDescriptorSetLayout(_device, &layoutInfo, nullptr, &_layout) != VK_SUCCESS) {
+		Log.FatalError("Vulkan", "Failed to create bindless descriptor set layout.");
+	}
+
+	VkDescriptorPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+	poolInfo.maxSets = 1;
+	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+	poolInfo.pPoolSizes = poolSizes.data();
+	if (vkCreateDescriptorPool(_device, &poolInfo, nullptr, &_pool) != VK_SUCCESS) {
+		Log.FatalError("Vulkan", "Failed to create bindless descriptor pool.");
+	}
+
+	VkDescriptorSetAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = _pool;
+	allocInfo.descriptorSetCount = 1;
+	allocInfo.pSetLayouts = &_layout;
+	if (vkAllocateDescriptorSets(_device, &allocInfo, &_set) != VK_SUCCESS) {
+		Log.FatalError("Vulkan", "Failed to allocate bindless descriptor set.");
+	}
+}
+
+bool BindlessRegistry::RequestFeatures(vkb::PhysicalDevice& physicalDevice)
+{
+	VkPhysicalDeviceVulkan12Features features{};
+	features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+	features.descriptorIndexing = true;
+	features.runtimeDescriptorArray = true;
+	features.descriptorBindingPartiallyBound = true;
+	features.descriptorBindingSampledImageUpdateAfterBind = true;
+	features.descriptorBindingStorageBufferUpdateAfterBind = true;
+	features.descriptorBindingUpdateUnusedWhilePending = true;
+	features.shaderSampledImageArrayNonUniformIndexing = true;
+	features.shaderStorageBufferArrayNonUniformIndexing = true;
+	return physicalDevice.enable_extension_features_if_present(features);
+}
+
+uint32_t BindlessRegistry::allocateIndex(Binding binding)
+{
+	Array& array = _arrays[static_cast<uint32_t>(binding)];
+	if (!array.freeIndices.empty()) {
+		uint32_t index = array.freeIndices.back();
+		array.freeIndices.pop_back();
+		return index;
+	}
+	if (array.next >= array.capacity) {
+		Log.Error("Vulkan", "Bindless descriptor array " + std::to_string(static_cast<uint32_t>(binding)) + " is full.");
+		return INVALID_INDEX;
+	}
+	return array.next++;
+}
+
+uint32_t BindlessRegistry::AddImage(VkImageView view, VkImageLayout layout)
+{
+	uint32_t index = allocateIndex(Binding::SampledImages);
+	if (index == INVALID_INDEX) return index;
+
+	VkDescriptorImageInfo imageInfo{};
+	imageInfo.imageView = view;
+	imageInfo.imageLayout = layout;
+
+	VkWriteDescriptorSet write{};
+	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstSet = _set;
+	write.dstBinding = static_cast<uint32_t>(Binding::SampledImages);
+	write.dstArrayElement = index;
+	write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+	write.descriptorCount = 1;
+	write.pImageInfo = &imageInfo;
+	vkUpdateDescriptorSets(_device, 1, &write, 0, nullptr);
+	return index;
+}
+
+uint32_t BindlessRegistry::AddStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+{
+	uint32_t index = allocateIndex(Binding::StorageBuffers);
+	if (index == INVALID_INDEX) return index;
+
+	VkDescriptorBufferInfo bufferInfo{};
+	bufferInfo.buffer = buffer;
+	bufferInfo.offset = offset;
+	bufferInfo.range = range;
+
+	VkWriteDescriptorSet write{};
+	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstSet = _set;
+	write.dstBinding = static_cast<uint32_t>(Binding::StorageBuffers);
+	write.dstArrayElement = index;
+	write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	write.descriptorCount = 1;
+	write.pBufferInfo = &bufferInfo;
+	vkUpdateDescriptorSets(_device, 1, &write, 0, nullptr);
+	return index;
+}
+
+uint32_t BindlessRegistry::AddSampler(VkSampler sampler)
+{
+	uint32_t index = allocateIndex(Binding::Samplers);
+	if (index == INVALID_INDEX) return index;
+
+	VkDescriptorImageInfo samplerInfo{};
+	samplerInfo.sampler = sampler;
+
+	VkWriteDescriptorSet write{};
+	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.dstSet = _set;
+	write.dstBinding = static_cast<uint32_t>(Binding::Samplers);
+	write.dstArrayElement = index;
+	write.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+	write.descriptorCount = 1;
+	write.pImageInfo = &samplerInfo;
+	vkUpdateDescriptorSets(_device, 1, &write, 0, nullptr);
+	return index;
+}
+
+void BindlessRegistry::Remove(Binding binding, uint32_t index)
+{
+	if (index == INVALID_INDEX) return;
+	// The stale descriptor is left in place, the array is partially bound so nothing reads it until the index is reused.
+	_arrays[static_cast<uint32_t>(binding)].freeIndices.push_back(index);
+}
+
+void BindlessRegistry::Bind(VkCommandBuffer cmd, VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint32_t setIndex) const
+{
+	vkCmdBindDescriptorSets(cmd, bindPoint, layout, setIndex, 1, &_set, 0, nullptr);
+}
+
+VkPushConstantRange BindlessRegistry::GetPushConstantRange()
+{
+	VkPushConstantRange range{};
+	range.stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS;
+	range.offset = 0;
+	range.size = sizeof(DrawIndices);
+	return range;
+}
+
+BindlessRegistry::~BindlessRegistry()
+{
+	vkDestroyDescriptorPool(_device, _pool, nullptr);
+	vkDestroyDescriptorSetLayout(_device, _layout, nullptr);
+}
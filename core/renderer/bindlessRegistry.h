@@ -0,0 +1,63 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <external/vkBootstrap/VkBootstrap.h>
+#include "core/globals.h"
+#include <vector>
+
+// A single update-after-bind descriptor set holding every sampled image, storage buffer and sampler in use, each in its
+// own partially bound array. Resources are given a stable index into their array when added, and shaders index the
+// arrays directly, so the set is bound once per command buffer instead of once per draw.
+class BindlessRegistry {
+	public:
+	// Binding of each array within the set.
+	enum class Binding : uint32_t {
+		SampledImages = 0,
+		StorageBuffers = 1,
+		Samplers = 2,
+		Count
+	};
+	static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+	// Indices a draw passes to its shaders through push constants.
+	struct DrawIndices {
+		uint32_t image = INVALID_INDEX;
+		uint32_t sampler = INVALID_INDEX;
+		uint32_t buffer = INVALID_INDEX;
+		uint32_t object = INVALID_INDEX;
+	};
+
+	private:
+	struct Array {
+		VkDescriptorType type;
+		uint32_t capacity;
+		uint32_t next = 0;
+		std::vector<uint32_t> freeIndices{};
+	};
+
+	VkDevice _device;
+	VkDescriptorSetLayout _layout = nullptr;
+	VkDescriptorPool _pool = nullptr;
+	VkDescriptorSet _set = nullptr;
+	Array _arrays[static_cast<uint32_t>(Binding::Count)];
+
+	uint32_t allocateIndex(Binding binding);
+
+	public:
+	// The device must have been created with the features enabled by RequestFeatures.
+	BindlessRegistry(vkb::Device* device, const vkb::PhysicalDevice* physicalDevice);
+
+	// Enables the descriptor indexing features bindless needs if the device supports them all. Returns false otherwise.
+	static bool RequestFeatures(vkb::PhysicalDevice& physicalDevice);
+
+	uint32_t AddImage(VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	uint32_t AddStorageBuffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+	uint32_t AddSampler(VkSampler sampler);
+	// Makes an index available for reuse. The GPU must have finished with every command buffer that could read it.
+	void Remove(Binding binding, uint32_t index);
+
+	void Bind(VkCommandBuffer cmd, VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint32_t setIndex) const;
+	VkDescriptorSetLayout GetLayout() const { return _layout; }
+	static VkPushConstantRange GetPushConstantRange();
+
+	~BindlessRegistry();
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include "core/globals.h"
+#include <deque>
+#include <functional>
+
+// Defers the destruction of GPU objects until the work that last used them has retired.
+// Each entry is tagged with a monotonically increasing value (a frame index or timeline value) and is run by Retire
+// once the GPU is known to have completed that value.
+class DeletionQueue {
+	private:
+	struct Entry {
+		uint64_t lastUsed;
+		std::function<void()> destroy;
+	};
+	std::deque<Entry> _entries{};
+
+	public:
+	void Push(uint64_t lastUsed, std::function<void()> destroy) {
+		_entries.push_back({ lastUsed, std::move(destroy) });
+	}
+
+	// Destroys every object whose last use is at or before completed.
+	void Retire(uint64_t completed) {
+		// Entries are usually pushed in order, but don't rely on it so that late pushes with older tags aren't held back.
+		for (auto it = _entries.begin(); it != _entries.end();) {
+			if (it->lastUsed <= completed) {
+				it->destroy();
+				it = _entries.erase(it);
+			}
+			else {
+				it++;
+			}
+		}
+	}
+
+	// Destroys everything immediately. The caller must ensure the device is idle.
+	void Flush() {
+		for (Entry& entry : _entries) {
+			entry.destroy();
+		}
+		_entries.clear();
+	}
+
+	size_t Size() const { return _entries.size(); }
+
+	~DeletionQueue() {
+		if (!_entries.empty()) Log.Warn("DeletionQueue", std::to_string(_entries.size()) + " objects were never destroyed.");
+	}
+};
@@ -2,6 +2,7 @@
 #include <vulkan/vulkan.h>
 #include <external/vkBootstrap/VkBootstrap.h>
 #include "core/globals.h"
+#include <algorithm>
 #include <vector>
 
 // Descriptor sets and pools will all be unqiue to a single layout
@@ -11,7 +12,46 @@ class DescriptorAllocator {
 	
 	VkDevice _device;
 	VkDescriptorSetLayout _layout;
-	VkDescriptorPool _pool = nullptr;
+
+	static constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+
+	// Pools that sets are bump allocated from. When the current pool runs out it is moved to full and replaced by a
+	// ready pool, or a new one half again as large.
+	struct PoolChain {
+		VkDescriptorPool current = nullptr;
+		std::vector<VkDescriptorPool> full{};
+		std::vector<VkDescriptorPool> ready{};
+		uint32_t nextPoolSize = 1;
+	};
+	std::vector<PoolChain> _chains{};
+	uint32_t _currentChain = 0;
+
+	VkDescriptorPool createPool(PoolChain& chain) {
+		uint32_t setCount = chain.nextPoolSize;
+		chain.nextPoolSize = std::min(setCount + setCount / 2 + 1, MAX_SETS_PER_POOL);
+
+		std::vector<VkDescriptorPoolSize> poolSizes{};
+		for (uint32_t i = 0; i < _bindings.size(); i++)
+		{
+			VkDescriptorPoolSize poolSize{};
+			poolSize.type = _bindings[i].descriptorType;
+			poolSize.descriptorCount = static_cast<uint32_t>(_bindings[i].descriptorCount) * setCount;
+			
+			poolSizes.push_back(poolSize);
+
+		}
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+		poolInfo.pPoolSizes = poolSizes.data();
+		poolInfo.maxSets = setCount;
+		VkDescriptorPool pool;
+		if (vkCreateDescriptorPool(_device, &poolInfo, nullptr, &pool) != VK_SUCCESS) {
+			Log.FatalError("Vulkan", "failed to create descriptor pool!");
+		}
+		return pool;
+	}
 
 	public:
 	DescriptorAllocator(VkDevice device, std::vector<VkDescriptorSetLayoutBinding> layoutBindings, VkDescriptorSetLayoutCreateFlags layoutCreateFlags = 0) {
@@ -34,30 +74,34 @@ class DescriptorAllocator {
 
 	}
 
-	void CreatePool(uint32_t totalLayouts=1) {
-
-		std::vector<VkDescriptorPoolSize> poolSizes{};
-		for (uint32_t i = 0; i < _bindings.size(); i++)
-		{
-			VkDescriptorPoolSize poolSize{};
-			poolSize.type = _bindings[i].descriptorType;
-			poolSize.descriptorCount = static_cast<uint32_t>(_bindings[i].descriptorCount) * totalLayouts;
-			
-			poolSizes.push_back(poolSize);
-
+	// Sets up pool chains holding setsPerPool sets to begin with. With a frameCount above 1 the allocator is in per frame
+	// mode: each frame in flight gets its own chain, selected with BeginFrame, which is reset as a whole rather than
+	// freeing sets one by one.
+	void CreatePool(uint32_t setsPerPool=1, uint32_t frameCount=1) {
+		_chains = std::vector<PoolChain>(std::max(frameCount, 1u));
+		for (PoolChain& chain : _chains) {
+			chain.nextPoolSize = std::max(setsPerPool, 1u);
+			chain.current = createPool(chain);
 		}
+		_currentChain = 0;
+	}
 
-		VkDescriptorPoolCreateInfo poolInfo{};
-		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-		poolInfo.pPoolSizes = poolSizes.data();
-		poolInfo.maxSets = totalLayouts;
-		if (vkCreateDescriptorPool(_device, &poolInfo, nullptr, &_pool) != VK_SUCCESS) {
-			Log.FatalError("Vulkan", "failed to create descriptor pool!");
+	// Makes the chain for frameIndex current and recycles every set allocated from it. The caller must ensure the GPU
+	// has finished with the frame's sets.
+	void BeginFrame(uint32_t frameIndex) {
+		_currentChain = frameIndex % _chains.size();
+		PoolChain& chain = _chains[_currentChain];
+		vkResetDescriptorPool(_device, chain.current, 0);
+		for (VkDescriptorPool pool : chain.full) {
+			vkResetDescriptorPool(_device, pool, 0);
+			chain.ready.push_back(pool);
 		}
+		chain.full.clear();
 	}
 
-	std::vector<VkDescriptorSet> AllocateDescriptorSets(uint32_t setCount) const {
+	// Allocates from the current pool, moving on to a new one when it runs out. Allocation is a bump within the pool,
+	// sets are only ever returned by BeginFrame.
+	std::vector<VkDescriptorSet> AllocateDescriptorSets(uint32_t setCount) {
 
 		std::vector<VkDescriptorSetLayout> layouts(setCount);
 		for (uint32_t i = 0; i < setCount; i++)
@@ -69,18 +113,47 @@ class DescriptorAllocator {
 		VkDescriptorSetAllocateInfo allocInfo{};
 		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 		allocInfo.pSetLayouts = layouts.data();
-		allocInfo.descriptorPool = _pool;
 		allocInfo.descriptorSetCount = setCount;
-		vkAllocateDescriptorSets(_device, &allocInfo, sets.data());
+
+		PoolChain& chain = _chains[_currentChain];
+		allocInfo.descriptorPool = chain.current;
+		VkResult result = vkAllocateDescriptorSets(_device, &allocInfo, sets.data());
+		// A recycled pool may be smaller than setCount, so ready pools are tried in turn before a large enough pool is created.
+		while (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+			chain.full.push_back(chain.current);
+			if (!chain.ready.empty()) {
+				chain.current = chain.ready.back();
+				chain.ready.pop_back();
+				allocInfo.descriptorPool = chain.current;
+				result = vkAllocateDescriptorSets(_device, &allocInfo, sets.data());
+				continue;
+			}
+			chain.nextPoolSize = std::max(chain.nextPoolSize, setCount);
+			chain.current = createPool(chain);
+			allocInfo.descriptorPool = chain.current;
+			result = vkAllocateDescriptorSets(_device, &allocInfo, sets.data());
+			break;
+		}
+		if (result != VK_SUCCESS) {
+			Log.FatalError("Vulkan", "Failed to allocate descriptor sets.");
+		}
 		return sets;
 	}
 
+	VkDescriptorSet AllocateDescriptorSet() {
+		return AllocateDescriptorSets(1)[0];
+	}
+
 	VkDescriptorSetLayout GetLayoutObj() const {
 		return _layout;
 	}
 
 	~DescriptorAllocator() {
-		vkDestroyDescriptorPool(_device, _pool, nullptr);
+		for (PoolChain& chain : _chains) {
+			vkDestroyDescriptorPool(_device, chain.current, nullptr);
+			for (VkDescriptorPool pool : chain.full) vkDestroyDescriptorPool(_device, pool, nullptr);
+			for (VkDescriptorPool pool : chain.ready) vkDestroyDescriptorPool(_device, pool, nullptr);
+		}
 		vkDestroyDescriptorSetLayout(_device, _layout, nullptr);
 	}
 };
\ No newline at end of file
@@ -2,12 +2,16 @@
 #include <vulkan/vulkan.h>
 #include <external/vkBootstrap/VkBootstrap.h>
 #include "core/globals.h"
+#include "vkUtils.h"
 #include <vector>
+#include <span>
 class GraphicsPipelineBuilder {
     VkPipelineCreateFlags flags = 0;
     VkPipelineLayout layout = nullptr;
     VkPipelineLayoutCreateInfo layoutInfo;
     std::vector<VkPipelineShaderStageCreateInfo> stages;
+    // Hash of the SPIR-V of each stage, in the same order as stages.
+    std::vector<uint64_t> stageCodeHashes{};
     VkPipelineVertexInputStateCreateInfo vertexInputState;
     VkPipelineInputAssemblyStateCreateInfo inputAssemblyState;
     VkPipelineTessellationStateCreateInfo tessellationState;
@@ -17,6 +21,8 @@ class GraphicsPipelineBuilder {
     VkPipelineDepthStencilStateCreateInfo depthStencilState;
     VkPipelineColorBlendStateCreateInfo colorBlendState;
     VkPipelineDynamicStateCreateInfo dynamicState;
+    VkPipelineRenderingCreateInfo renderingInfo;
+    bool useDynamicRendering = false;
     uint32_t subpass = 0;
     VkPipeline basePipelineHandle = nullptr;
     int32_t basePipelineIndex = 0;
@@ -29,6 +35,7 @@ class GraphicsPipelineBuilder {
     std::vector<VkRect2D> viewportScissors{};
     std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachments{};
     std::vector<VkDynamicState> dynamicStates{};
+    std::vector<VkFormat> colorAttachmentFormats{};
     public:
     GraphicsPipelineBuilder() {
         stages = {};
@@ -42,15 +49,18 @@ class GraphicsPipelineBuilder {
         depthStencilState = { .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO };
         colorBlendState = { .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
         dynamicState = { .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
+        renderingInfo = { .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO };
     }
 
-    GraphicsPipelineBuilder AddShaderStage(VkShaderStageFlagBits stage, VkShaderModule sModule) {
+    // spirv is the code the module was created from, which identifies the stage in PipelineStateKey.
+    GraphicsPipelineBuilder AddShaderStage(VkShaderStageFlagBits stage, VkShaderModule sModule, std::span<const uint32_t> spirv) {
         VkPipelineShaderStageCreateInfo shaderStageCreateInfo{};
         shaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         shaderStageCreateInfo.stage = stage;
         shaderStageCreateInfo.module = sModule;
         shaderStageCreateInfo.pName = "main";
         stages.push_back(shaderStageCreateInfo);
+        stageCodeHashes.push_back(vkUtils::HashBytes(spirv.data(), spirv.size_bytes()));
         return *this;
     }
 
@@ -156,16 +166,129 @@ class GraphicsPipelineBuilder {
         return *this;
     }
 
+    // Attachment formats for use with dynamic rendering, in which case the pipeline is built without a render pass.
+    GraphicsPipelineBuilder SetRenderingFormats(std::vector<VkFormat> colorFormats, VkFormat depthFormat = VK_FORMAT_UNDEFINED, VkFormat stencilFormat = VK_FORMAT_UNDEFINED) {
+        colorAttachmentFormats = std::vector<VkFormat>(colorFormats);
+        renderingInfo.colorAttachmentCount = static_cast<uint32_t>(colorAttachmentFormats.size());
+        renderingInfo.pColorAttachmentFormats = colorAttachmentFormats.data();
+        renderingInfo.depthAttachmentFormat = depthFormat;
+        renderingInfo.stencilAttachmentFormat = stencilFormat;
+        useDynamicRendering = true;
+        return *this;
+    }
+
+    // Use an already created layout instead of building a new one with BuildLayout.
+    GraphicsPipelineBuilder UseLayout(VkPipelineLayout existingLayout) {
+        layout = existingLayout;
+        return *this;
+    }
+
+    // Key of the state used to create the pipeline layout.
+    vkUtils::StateKey LayoutStateKey() const {
+        vkUtils::StateKey key{};
+        key.Add(layoutInfo.flags);
+        key.AddArray(pushConstantRanges.data(), pushConstantRanges.size());
+        key.AddArray(descriptorLayouts.data(), descriptorLayouts.size());
+        return key;
+    }
+
+    // Key of all state that affects the pipeline built by BuildPipeline, including the layout handle and render pass.
+    // Builders with equal keys produce interchangeable pipelines. Shaders are keyed by their SPIR-V, not their module
+    // handle, since a handle can be reused once its module is destroyed.
+    vkUtils::StateKey PipelineStateKey(VkRenderPass renderPass) const {
+        vkUtils::StateKey key{};
+        key.Add(flags);
+        key.Add(stages.size());
+        for (size_t i = 0; i < stages.size(); i++) {
+            const VkPipelineShaderStageCreateInfo& stage = stages[i];
+            key.Add(stage.flags);
+            key.Add(stage.stage);
+            key.Add(stageCodeHashes[i]);
+            key.AddString(stage.pName);
+            const VkSpecializationInfo* specialization = stage.pSpecializationInfo;
+            key.Add(specialization != nullptr);
+            if (specialization != nullptr) {
+                key.AddArray(specialization->pMapEntries, specialization->mapEntryCount);
+                key.AddArray(static_cast<const uint8_t*>(specialization->pData), specialization->dataSize);
+            }
+        }
+
+        key.Add(vertexInputState.flags);
+        key.AddArray(vertexInputAttributeDescriptions.data(), vertexInputAttributeDescriptions.size());
+        key.AddArray(vertexInputBindingDescriptions.data(), vertexInputBindingDescriptions.size());
+
+        key.Add(inputAssemblyState.flags);
+        key.Add(inputAssemblyState.topology);
+        key.Add(inputAssemblyState.primitiveRestartEnable);
+
+        key.Add(tessellationState.flags);
+        key.Add(tessellationState.patchControlPoints);
+
+        key.Add(viewportState.flags);
+        key.Add(viewportState.viewportCount);
+        key.Add(viewportState.scissorCount);
+        key.AddArray(viewportStateViewports.data(), viewportStateViewports.size());
+        key.AddArray(viewportScissors.data(), viewportScissors.size());
+
+        key.Add(rasterizationState.flags);
+        key.Add(rasterizationState.depthClampEnable);
+        key.Add(rasterizationState.rasterizerDiscardEnable);
+        key.Add(rasterizationState.polygonMode);
+        key.Add(rasterizationState.cullMode);
+        key.Add(rasterizationState.frontFace);
+        key.Add(rasterizationState.depthBiasEnable);
+        key.Add(rasterizationState.depthBiasConstantFactor);
+        key.Add(rasterizationState.depthBiasClamp);
+        key.Add(rasterizationState.depthBiasSlopeFactor);
+        key.Add(rasterizationState.lineWidth);
+
+        key.Add(multisampleState.flags);
+        key.Add(multisampleState.rasterizationSamples);
+        key.Add(multisampleState.sampleShadingEnable);
+        key.Add(multisampleState.minSampleShading);
+        key.Add(multisampleState.alphaToCoverageEnable);
+        key.Add(multisampleState.alphaToOneEnable);
+        key.Add(multisampleState.pSampleMask != nullptr);
+        if (multisampleState.pSampleMask) key.Add(*multisampleState.pSampleMask);
+
+        key.Add(depthStencilState.flags);
+
+        key.Add(colorBlendState.flags);
+        key.Add(colorBlendState.logicOpEnable);
+        key.Add(colorBlendState.logicOp);
+        key.AddArray(colorBlendAttachments.data(), colorBlendAttachments.size());
+        key.Add(colorBlendState.blendConstants);
+
+        key.Add(dynamicState.flags);
+        key.AddArray(dynamicStates.data(), dynamicStates.size());
+
+        key.Add(useDynamicRendering);
+        if (useDynamicRendering) {
+            key.AddArray(colorAttachmentFormats.data(), colorAttachmentFormats.size());
+            key.Add(renderingInfo.depthAttachmentFormat);
+            key.Add(renderingInfo.stencilAttachmentFormat);
+        }
+
+        key.Add(layout);
+        key.Add(renderPass);
+        key.Add(subpass);
+        return key;
+    }
+
     VkPipelineLayout BuildLayout(vkb::Device* device) {
+        updateStatePointers();
         if (vkCreatePipelineLayout(*device, &layoutInfo, nullptr, &layout) != VK_SUCCESS) {
             Log.FatalError("Vulkan", "Failed to build graphics pipeline layout.");
         }
         return layout;
     }
-    VkPipeline BuildPipeline(vkb::Device* device, VkRenderPass renderPass) {
 
+    // Fills in a create info pointing at this builder's state. The builder must outlive any use of the returned struct.
+    VkGraphicsPipelineCreateInfo GetCreateInfo(VkRenderPass renderPass) {
+        updateStatePointers();
         VkGraphicsPipelineCreateInfo info{};
         info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        info.pNext = useDynamicRendering ? &renderingInfo : nullptr;
         info.flags = flags;
         info.stageCount = static_cast<uint32_t>(stages.size());
         info.pStages = stages.data();
@@ -183,11 +306,30 @@ class GraphicsPipelineBuilder {
         info.subpass = subpass;
         info.basePipelineHandle = basePipelineHandle;
         info.basePipelineIndex = basePipelineIndex;
+        return info;
+    }
+
+    VkPipeline BuildPipeline(vkb::Device* device, VkRenderPass renderPass, VkPipelineCache cache = VK_NULL_HANDLE) {
+        VkGraphicsPipelineCreateInfo info = GetCreateInfo(renderPass);
         VkPipeline pipeline;
         
-        if (vkCreateGraphicsPipelines(*device, VK_NULL_HANDLE, 1, &info, nullptr, &pipeline) != VK_SUCCESS) {
+        if (vkCreateGraphicsPipelines(*device, cache, 1, &info, nullptr, &pipeline) != VK_SUCCESS) {
             Log.FatalError("Vulkan", "Failed to build graphics pipeline.");
         }
         return pipeline;
     }
+
+    private:
+    // The create info structs point into this builder's vectors, which are left dangling when the builder is copied.
+    void updateStatePointers() {
+        layoutInfo.pPushConstantRanges = pushConstantRanges.data();
+        layoutInfo.pSetLayouts = descriptorLayouts.data();
+        vertexInputState.pVertexAttributeDescriptions = vertexInputAttributeDescriptions.data();
+        vertexInputState.pVertexBindingDescriptions = vertexInputBindingDescriptions.data();
+        viewportState.pViewports = viewportStateViewports.data();
+        viewportState.pScissors = viewportScissors.data();
+        colorBlendState.pAttachments = colorBlendAttachments.data();
+        dynamicState.pDynamicStates = dynamicStates.data();
+        renderingInfo.pColorAttachmentFormats = colorAttachmentFormats.data();
+    }
 };
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "pipelineCache.h"
+#include "filesystem/engine_io.h"
+#include <cstring>
+
+PipelineCache::PipelineCache(vkb::Device* device, const vkb::PhysicalDevice* physicalDevice, string filePath)
+{
+	_device = *device;
+	_deviceProperties = physicalDevice->properties;
+	_filePath = filePath;
+
+	std::vector<uint8_t> initialData = loadValidatedData();
+
+	VkPipelineCacheCreateInfo createInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	createInfo.initialDataSize = initialData.size();
+	createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+	if (vkCreatePipelineCache(_device, &createInfo, nullptr, &_cache) != VK_SUCCESS) {
+		Log.FatalError("Vulkan", "Failed to create pipeline cache.");
+	}
+}
+
+std::vector<uint8_t> PipelineCache::loadValidatedData() const
+{
+	if (!EngineIO::FileSystem::FileExists(_filePath)) {
+		Log.Debug("PipelineCache", "No pipeline cache found, pipelines will be compiled from scratch.");
+		return {};
+	}
+
+	EngineIO::File cacheFile = EngineIO::FileSystem::OpenFile(_filePath, std::ios::in | std::ios::binary);
+	vector<uint8_t> fileData = cacheFile.ReadAllBinary();
+
+	CacheFileHeader header{};
+	if (fileData.size() < sizeof(CacheFileHeader)) {
+		Log.Warn("PipelineCache", "Pipeline cache file is truncated, discarding.");
+		return {};
+	}
+	memcpy(&header, fileData.data(), sizeof(CacheFileHeader));
+
+	if (header.magic != CACHE_FILE_MAGIC ||
+		header.vendorID != _deviceProperties.vendorID ||
+		header.deviceID != _deviceProperties.deviceID ||
+		header.driverVersion != _deviceProperties.driverVersion ||
+		memcmp(header.pipelineCacheUUID, _deviceProperties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+		Log.Info("PipelineCache", "Pipeline cache was created by a different device or driver, discarding.");
+		return {};
+	}
+
+	if (header.dataSize != fileData.size() - sizeof(CacheFileHeader)) {
+		Log.Warn("PipelineCache", "Pipeline cache file size does not match its header, discarding.");
+		return {};
+	}
+
+	return { fileData.begin() + sizeof(CacheFileHeader), fileData.end() };
+}
+
+void PipelineCache::Save() const
+{
+	size_t dataSize = 0;
+	if (vkGetPipelineCacheData(_device, _cache, &dataSize, nullptr) != VK_SUCCESS) {
+		Log.Warn("PipelineCache", "Failed to query pipeline cache size.");
+		return;
+	}
+
+	std::vector<uint8_t> data(dataSize);
+	if (vkGetPipelineCacheData(_device, _cache, &dataSize, data.data()) != VK_SUCCESS) {
+		Log.Warn("PipelineCache", "Failed to read pipeline cache data.");
+		return;
+	}
+
+	CacheFileHeader header{};
+	header.magic = CACHE_FILE_MAGIC;
+	header.vendorID = _deviceProperties.vendorID;
+	header.deviceID = _deviceProperties.deviceID;
+	header.driverVersion = _deviceProperties.driverVersion;
+	memcpy(header.pipelineCacheUUID, _deviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+	header.dataSize = dataSize;
+
+	filesystem::create_directories(filesystem::path(_filePath).parent_path());
+	EngineIO::File cacheFile = EngineIO::FileSystem::OpenOrCreateFile(_filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+	fstream* outStream = cacheFile.GetFileStream();
+	outStream->write(reinterpret_cast<const char*>(&header), sizeof(CacheFileHeader));
+	outStream->write(reinterpret_cast<const char*>(data.data()), dataSize);
+
+	Log.Debug("PipelineCache", "Saved " + std::to_string(dataSize) + " bytes of pipeline cache data.");
+}
+
+PipelineCache::~PipelineCache()
+{
+	vkDestroyPipelineCache(_device, _cache, nullptr);
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <external/vkBootstrap/VkBootstrap.h>
+#include "core/globals.h"
+#include <vector>
+
+// Owns the VkPipelineCache shared by every pipeline the renderer builds, and persists it to disk between runs.
+// The on disk blob is prefixed with the identity of the device that produced it, and is discarded if that doesn't match the current device.
+class PipelineCache {
+	private:
+	struct CacheFileHeader {
+		uint32_t magic;
+		uint32_t vendorID;
+		uint32_t deviceID;
+		uint32_t driverVersion;
+		uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+		uint64_t dataSize;
+	};
+	static constexpr uint32_t CACHE_FILE_MAGIC = 0x43505347; // "GSPC"
+
+	VkDevice _device;
+	VkPhysicalDeviceProperties _deviceProperties;
+	string _filePath;
+	VkPipelineCache _cache = VK_NULL_HANDLE;
+
+	std::vector<uint8_t> loadValidatedData() const;
+
+	public:
+	PipelineCache(vkb::Device* device, const vkb::PhysicalDevice* physicalDevice, string filePath = ".gusengine/pipeline_cache");
+	VkPipelineCache Get() const { return _cache; }
+	void Save() const;
+	~PipelineCache();
+};
@@ -0,0 +1,168 @@
+#include "pipelineRegistry.h"
+#include <algorithm>
+
+PipelineRegistry::PipelineRegistry(vkb::Device* device, VkPipelineCache cache)
+{
+	_device = device;
+	_cache = cache;
+}
+
+VkPipelineLayout PipelineRegistry::GetOrCreateLayout(GraphicsPipelineBuilder& builder)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	vkUtils::StateKey key = builder.LayoutStateKey();
+	auto it = _layouts.find(key);
+	if (it != _layouts.end()) {
+		_layoutHits++;
+		builder.UseLayout(it->second);
+		return it->second;
+	}
+
+	_layoutMisses++;
+	VkPipelineLayout layout = builder.BuildLayout(_device);
+	_layouts.emplace(std::move(key), layout);
+	return layout;
+}
+
+VkPipeline PipelineRegistry::GetOrCreatePipeline(GraphicsPipelineBuilder& builder, VkRenderPass renderPass)
+{
+	vkUtils::StateKey key = builder.PipelineStateKey(renderPass);
+	PipelineHandle handle;
+	bool compileHere = false;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto it = _pipelines.find(key);
+		if (it != _pipelines.end()) {
+			_pipelineHits++;
+			return it->second;
+		}
+
+		auto pendingIt = _pendingPipelines.find(key);
+		if (pendingIt != _pendingPipelines.end()) {
+			_pipelineHits++;
+			handle = pendingIt->second;
+		}
+		else {
+			_pipelineMisses++;
+			handle._state = std::make_shared<PipelineHandle::State>();
+			_pendingPipelines[key] = handle;
+			compileHere = true;
+		}
+	}
+
+	// Compile outside the lock so that batch workers can keep publishing their results.
+	if (compileHere) {
+		VkPipeline pipeline = builder.BuildPipeline(_device, renderPass, _cache);
+		std::lock_guard<std::mutex> lock(_mutex);
+		publishPipeline(key, handle, pipeline);
+		return pipeline;
+	}
+
+	return handle.Wait();
+}
+
+std::vector<PipelineHandle> PipelineRegistry::CompileBatch(const std::vector<GraphicsPipelineBuilder>& builders, VkRenderPass renderPass)
+{
+	std::vector<PipelineHandle> handles(builders.size());
+	std::vector<size_t> toCompile{};
+	std::vector<vkUtils::StateKey> keys(builders.size());
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (size_t i = 0; i < builders.size(); i++)
+		{
+			keys[i] = builders[i].PipelineStateKey(renderPass);
+
+			auto it = _pipelines.find(keys[i]);
+			if (it != _pipelines.end()) {
+				_pipelineHits++;
+				handles[i]._state = std::make_shared<PipelineHandle::State>();
+				handles[i]._state->pipeline = it->second;
+				handles[i]._state->done = true;
+				continue;
+			}
+
+			auto pendingIt = _pendingPipelines.find(keys[i]);
+			if (pendingIt != _pendingPipelines.end()) {
+				_pipelineHits++;
+				handles[i] = pendingIt->second;
+				continue;
+			}
+
+			_pipelineMisses++;
+			handles[i]._state = std::make_shared<PipelineHandle::State>();
+			_pendingPipelines[keys[i]] = handles[i];
+			toCompile.push_back(i);
+		}
+	}
+
+	if (toCompile.empty()) return handles;
+
+	size_t workers = _compilePool.ThreadCount();
+	size_t chunkSize = std::clamp<size_t>((toCompile.size() + workers - 1) / workers, 1, MAX_BATCH_CHUNK_SIZE);
+
+	for (size_t start = 0; start < toCompile.size(); start += chunkSize)
+	{
+		size_t end = std::min(start + chunkSize, toCompile.size());
+		std::vector<GraphicsPipelineBuilder> chunkBuilders{};
+		std::vector<vkUtils::StateKey> chunkKeys{};
+		std::vector<PipelineHandle> chunkHandles{};
+		for (size_t i = start; i < end; i++)
+		{
+			chunkBuilders.push_back(builders[toCompile[i]]);
+			chunkKeys.push_back(std::move(keys[toCompile[i]]));
+			chunkHandles.push_back(handles[toCompile[i]]);
+		}
+
+		_compilePool.Submit([this, chunkBuilders = std::move(chunkBuilders), chunkKeys = std::move(chunkKeys), chunkHandles = std::move(chunkHandles), renderPass]() mutable {
+			compileChunk(std::move(chunkBuilders), std::move(chunkKeys), std::move(chunkHandles), renderPass);
+		});
+	}
+
+	return handles;
+}
+
+void PipelineRegistry::compileChunk(std::vector<GraphicsPipelineBuilder> builders, std::vector<vkUtils::StateKey> keys, std::vector<PipelineHandle> handles, VkRenderPass renderPass)
+{
+	std::vector<VkGraphicsPipelineCreateInfo> infos(builders.size());
+	for (size_t i = 0; i < builders.size(); i++)
+	{
+		infos[i] = builders[i].GetCreateInfo(renderPass);
+	}
+
+	// Pipelines that fail to compile are left as VK_NULL_HANDLE, so their handles keep returning the fallback.
+	std::vector<VkPipeline> pipelines(builders.size(), VK_NULL_HANDLE);
+	VkResult result = vkCreateGraphicsPipelines(*_device, _cache, static_cast<uint32_t>(infos.size()), infos.data(), nullptr, pipelines.data());
+	if (result != VK_SUCCESS) {
+		Log.Warn("PipelineRegistry", "Failed to build " + std::to_string(infos.size()) + " graphics pipelines in batch.");
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (size_t i = 0; i < pipelines.size(); i++)
+	{
+		publishPipeline(keys[i], handles[i], pipelines[i]);
+	}
+}
+
+void PipelineRegistry::publishPipeline(const vkUtils::StateKey& key, PipelineHandle& handle, VkPipeline pipeline)
+{
+	if (pipeline != VK_NULL_HANDLE) {
+		_pipelines[key] = pipeline;
+	}
+	_pendingPipelines.erase(key);
+	handle._state->pipeline.store(pipeline, std::memory_order_release);
+	handle._state->done.store(true, std::memory_order_release);
+	handle._state->done.notify_all();
+}
+
+PipelineRegistry::~PipelineRegistry()
+{
+	_compilePool.WaitIdle();
+	Log.Debug("PipelineRegistry", "Pipelines: " + std::to_string(_pipelineHits) + " hits, " + std::to_string(_pipelineMisses) + " misses.");
+	for (const auto& [key, pipeline] : _pipelines) {
+		vkDestroyPipeline(*_device, pipeline, nullptr);
+	}
+	for (const auto& [key, layout] : _layouts) {
+		vkDestroyPipelineLayout(*_device, layout, nullptr);
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <external/vkBootstrap/VkBootstrap.h>
+#include "core/globals.h"
+#include "graphicsPipeline.h"
+#include "utils/threadPool.h"
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <mutex>
+
+// A pipeline that may still be compiling on a worker thread.
+class PipelineHandle {
+	friend class PipelineRegistry;
+	private:
+	struct State {
+		std::atomic<VkPipeline> pipeline = VK_NULL_HANDLE;
+		std::atomic<bool> done = false;
+	};
+	std::shared_ptr<State> _state;
+
+	public:
+	bool IsValid() const { return _state != nullptr; }
+	bool IsReady() const { return _state && _state->done.load(std::memory_order_acquire); }
+	// Returns the compiled pipeline, or the fallback if it is not ready yet or failed to compile.
+	VkPipeline Get(VkPipeline fallback = VK_NULL_HANDLE) const {
+		if (!IsReady()) return fallback;
+		VkPipeline pipeline = _state->pipeline.load(std::memory_order_acquire);
+		return pipeline != VK_NULL_HANDLE ? pipeline : fallback;
+	}
+	// Blocks until compilation has finished.
+	VkPipeline Wait() const {
+		if (!_state) return VK_NULL_HANDLE;
+		_state->done.wait(false, std::memory_order_acquire);
+		return _state->pipeline.load(std::memory_order_acquire);
+	}
+};
+
+// Deduplicates pipelines and pipeline layouts built from GraphicsPipelineBuilder, keyed on the builder's state.
+// The registry owns every object it returns, and destroys them when it is deleted.
+class PipelineRegistry {
+	private:
+	// Upper bound on the number of pipelines passed to a single vkCreateGraphicsPipelines call.
+	static constexpr size_t MAX_BATCH_CHUNK_SIZE = 16;
+
+	vkb::Device* _device;
+	VkPipelineCache _cache;
+	ThreadPool _compilePool;
+	std::mutex _mutex;
+
+	std::unordered_map<vkUtils::StateKey, VkPipelineLayout, vkUtils::StateKeyHash> _layouts{};
+	std::unordered_map<vkUtils::StateKey, VkPipeline, vkUtils::StateKeyHash> _pipelines{};
+	std::unordered_map<vkUtils::StateKey, PipelineHandle, vkUtils::StateKeyHash> _pendingPipelines{};
+
+	uint32_t _pipelineHits = 0;
+	uint32_t _pipelineMisses = 0;
+	uint32_t _layoutHits = 0;
+	uint32_t _layoutMisses = 0;
+
+	// Must be called with _mutex held.
+	void publishPipeline(const vkUtils::StateKey& key, PipelineHandle& handle, VkPipeline pipeline);
+	void compileChunk(std::vector<GraphicsPipelineBuilder> builders, std::vector<vkUtils::StateKey> keys, std::vector<PipelineHandle> handles, VkRenderPass renderPass);
+
+	public:
+	PipelineRegistry(vkb::Device* device, VkPipelineCache cache = VK_NULL_HANDLE);
+
+	// Returns a layout matching the builder's layout state, creating one if needed. The builder is updated to use the returned layout.
+	VkPipelineLayout GetOrCreateLayout(GraphicsPipelineBuilder& builder);
+	// Returns a pipeline matching the builder's state, creating one if needed. Blocks if a matching pipeline is still being compiled.
+	VkPipeline GetOrCreatePipeline(GraphicsPipelineBuilder& builder, VkRenderPass renderPass);
+
+	// Compiles the given builders on worker threads, split into chunks that are each created with a single vkCreateGraphicsPipelines call.
+	// Each builder must already have a layout. Returns one handle per builder, in order; duplicate state shares a handle.
+	std::vector<PipelineHandle> CompileBatch(const std::vector<GraphicsPipelineBuilder>& builders, VkRenderPass renderPass);
+
+	uint32_t GetPipelineHits() const { return _pipelineHits; }
+	uint32_t GetPipelineMisses() const { return _pipelineMisses; }
+	uint32_t GetLayoutHits() const { return _layoutHits; }
+	uint32_t GetLayoutMisses() const { return _layoutMisses; }
+	size_t GetPipelineCount() const { return _pipelines.size(); }
+
+	~PipelineRegistry();
+};
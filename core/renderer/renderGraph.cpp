@@ -0,0 +1,530 @@
+#include "renderGraph.h"
+#include "vkUtils.h"
+#include <algorithm>
+#include <set>
+
+struct UsageInfo {
+	VkPipelineStageFlags2 stages;
+	VkAccessFlags2 access;
+	VkImageLayout layout;
+	VkImageUsageFlags imageUsage;
+	bool attachment;
+};
+
+static UsageInfo getUsageInfo(ResourceUsage usage)
+{
+	constexpr VkPipelineStageFlags2 depthStages = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+	switch (usage) {
+		case ResourceUsage::ColorAttachment:
+			return { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+				VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, true };
+		case ResourceUsage::DepthAttachment:
+			return { depthStages, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+				VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, true };
+		case ResourceUsage::DepthRead:
+			return { depthStages, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+				VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, true };
+		case ResourceUsage::SampledFragment:
+			return { VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, false };
+		case ResourceUsage::SampledCompute:
+			return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+				VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, false };
+		case ResourceUsage::StorageRead:
+			return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+				VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, false };
+		case ResourceUsage::StorageWrite:
+			return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+				VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, false };
+		case ResourceUsage::TransferSrc:
+			return { VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT,
+				VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT, false };
+		case ResourceUsage::TransferDst:
+			return { VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT, false };
+	}
+	return {};
+}
+
+static VkImageAspectFlags aspectFromFormat(VkFormat format)
+{
+	switch (format) {
+		case VK_FORMAT_D16_UNORM:
+		case VK_FORMAT_X8_D24_UNORM_PACK32:
+		case VK_FORMAT_D32_SFLOAT:
+			return VK_IMAGE_ASPECT_DEPTH_BIT;
+		case VK_FORMAT_D16_UNORM_S8_UINT:
+		case VK_FORMAT_D24_UNORM_S8_UINT:
+		case VK_FORMAT_D32_SFLOAT_S8_UINT:
+			return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+		case VK_FORMAT_S8_UINT:
+			return VK_IMAGE_ASPECT_STENCIL_BIT;
+		default:
+			return VK_IMAGE_ASPECT_COLOR_BIT;
+	}
+}
+
+void RenderGraph::PassBuilder::Read(ResourceId resource, ResourceUsage usage)
+{
+	_pass.usages.push_back({ resource, usage, false, {} });
+}
+
+void RenderGraph::PassBuilder::Write(ResourceId resource, ResourceUsage usage, std::optional<VkClearValue> clear)
+{
+	_pass.usages.push_back({ resource, usage, true, clear });
+}
+
+RenderGraph::RenderGraph(vkb::Device* device, Allocator* allocator)
+{
+	_device = device;
+	_allocator = allocator;
+}
+
+RenderGraph::ResourceId RenderGraph::CreateImage(string name, ImageDesc desc)
+{
+	Resource resource{};
+	resource.name = name;
+	resource.imported = false;
+	resource.format = desc.format;
+	resource.extent = desc.extent;
+	resource.aspect = aspectFromFormat(desc.format);
+	resource.usage = desc.extraUsage;
+	_resources.push_back(resource);
+	return static_cast<ResourceId>(_resources.size() - 1);
+}
+
+RenderGraph::ResourceId RenderGraph::ImportImage(string name, ImportedImage image)
+{
+	Resource resource{};
+	resource.name = name;
+	resource.imported = true;
+	resource.image = image.image;
+	resource.view = image.view;
+	resource.format = image.format;
+	resource.extent = image.extent;
+	resource.aspect = aspectFromFormat(image.format);
+	resource.import = image;
+	_resources.push_back(resource);
+	return static_cast<ResourceId>(_resources.size() - 1);
+}
+
+void RenderGraph::AddPass(string name, std::function<void(PassBuilder&)> setup, ExecuteFunc execute)
+{
+	Pass& pass = _passes.emplace_back();
+	pass.name = name;
+	pass.execute = execute;
+	PassBuilder builder(pass);
+	setup(builder);
+}
+
+void RenderGraph::Compile()
+{
+	cullPasses();
+	computeLifetimes();
+	realiseTransients();
+	buildBarriers();
+	_compiled = true;
+}
+
+// Walks the passes backwards from the graph outputs. A pass is kept if it writes content a kept pass or an output
+// depends on, and everything it reads then becomes needed in turn. Attachments written without a clear keep
+// earlier contents, so they count as reads as well.
+void RenderGraph::cullPasses()
+{
+	std::set<ResourceId> needed{};
+	for (ResourceId i = 0; i < _resources.size(); i++) {
+		if (_resources[i].imported && _resources[i].import.finalLayout != VK_IMAGE_LAYOUT_UNDEFINED) needed.insert(i);
+	}
+
+	for (int32_t p = static_cast<int32_t>(_passes.size()) - 1; p >= 0; p--) {
+		Pass& pass = _passes[p];
+		pass.culled = !pass.sideEffects;
+		for (const PassUsage& use : pass.usages) {
+			if (use.write && needed.contains(use.resource)) pass.culled = false;
+		}
+		if (pass.culled) continue;
+
+		for (const PassUsage& use : pass.usages) {
+			if (use.write) needed.erase(use.resource);
+		}
+		for (const PassUsage& use : pass.usages) {
+			bool preservesContents = use.write && getUsageInfo(use.usage).attachment && !use.clear.has_value();
+			if (!use.write || preservesContents) needed.insert(use.resource);
+		}
+	}
+}
+
+void RenderGraph::computeLifetimes()
+{
+	for (int32_t p = 0; p < static_cast<int32_t>(_passes.size()); p++) {
+		if (_passes[p].culled) continue;
+		for (const PassUsage& use : _passes[p].usages) {
+			Resource& resource = _resources[use.resource];
+			if (resource.firstPass < 0) resource.firstPass = p;
+			resource.lastPass = p;
+			resource.usage |= getUsageInfo(use.usage).imageUsage;
+		}
+	}
+}
+
+// Creates the transient images and packs them into as few allocations as possible. Images are placed largest first
+// into the first allocation whose other occupants are dead for the image's whole lifetime, so that passes far apart
+// in the frame reuse the same memory. The result is kept until the set of transients changes.
+void RenderGraph::realiseTransients()
+{
+	std::vector<ResourceId> transients{};
+	uint64_t hash = vkUtils::HASH_SEED;
+	for (ResourceId i = 0; i < _resources.size(); i++) {
+		const Resource& resource = _resources[i];
+		if (resource.imported || resource.firstPass < 0) continue;
+		transients.push_back(i);
+		hash = vkUtils::HashValue(resource.format, hash);
+		hash = vkUtils::HashValue(resource.extent, hash);
+		hash = vkUtils::HashValue(resource.usage, hash);
+		hash = vkUtils::HashValue(resource.firstPass, hash);
+		hash = vkUtils::HashValue(resource.lastPass, hash);
+	}
+
+	if (hash != _transientHash || transients.size() != _transientImages.size()) {
+		destroyTransients();
+		_transientHash = hash;
+
+		std::vector<VkMemoryRequirements> requirements(transients.size());
+		_transientImages.resize(transients.size());
+		for (size_t i = 0; i < transients.size(); i++) {
+			const Resource& resource = _resources[transients[i]];
+			VkImageCreateInfo imageInfo{};
+			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageInfo.format = resource.format;
+			imageInfo.extent = { resource.extent.width, resource.extent.height, 1 };
+			imageInfo.mipLevels = 1;
+			imageInfo.arrayLayers = 1;
+			imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+			imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageInfo.usage = resource.usage;
+			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			if (vkCreateImage(*_device, &imageInfo, nullptr, &_transientImages[i].image) != VK_SUCCESS) {
+				Log.FatalError("Vulkan", "Failed to create transient image " + resource.name + ".");
+			}
+			vkGetImageMemoryRequirements(*_device, _transientImages[i].image, &requirements[i]);
+		}
+
+		std::vector<size_t> order(transients.size());
+		for (size_t i = 0; i < order.size(); i++) order[i] = i;
+		std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return requirements[a].size > requirements[b].size; });
+
+		struct Slot {
+			VkMemoryRequirements requirements;
+			std::vector<size_t> occupants;
+		};
+		std::vector<Slot> slots{};
+		std::vector<size_t> slotOf(transients.size());
+		for (size_t i : order) {
+			const Resource& resource = _resources[transients[i]];
+			size_t chosen = slots.size();
+			for (size_t s = 0; s < slots.size() && chosen == slots.size(); s++) {
+				if ((slots[s].requirements.memoryTypeBits & requirements[i].memoryTypeBits) == 0) continue;
+				bool overlaps = false;
+				for (size_t other : slots[s].occupants) {
+					const Resource& occupant = _resources[transients[other]];
+					if (resource.firstPass <= occupant.lastPass && occupant.firstPass <= resource.lastPass) overlaps = true;
+				}
+				if (!overlaps) chosen = s;
+			}
+			if (chosen == slots.size()) {
+				slots.push_back({ requirements[i], {} });
+			}
+			Slot& slot = slots[chosen];
+			slot.requirements.size = std::max(slot.requirements.size, requirements[i].size);
+			slot.requirements.alignment = std::max(slot.requirements.alignment, requirements[i].alignment);
+			slot.requirements.memoryTypeBits &= requirements[i].memoryTypeBits;
+			slot.occupants.push_back(i);
+			slotOf[i] = chosen;
+		}
+
+		_transientMemory.resize(slots.size());
+		for (size_t s = 0; s < slots.size(); s++) {
+			_allocator->allocateMemory(&_transientMemory[s], slots[s].requirements);
+		}
+
+		for (size_t i = 0; i < transients.size(); i++) {
+			const Resource& resource = _resources[transients[i]];
+			_transientImages[i].memory = slotOf[i];
+			_allocator->bindImageMemory(&_transientMemory[slotOf[i]], _transientImages[i].image);
+
+			VkImageViewCreateInfo viewInfo{};
+			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewInfo.image = _transientImages[i].image;
+			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			viewInfo.format = resource.format;
+			viewInfo.subresourceRange.aspectMask = resource.aspect;
+			viewInfo.subresourceRange.baseMipLevel = 0;
+			viewInfo.subresourceRange.levelCount = 1;
+			viewInfo.subresourceRange.baseArrayLayer = 0;
+			viewInfo.subresourceRange.layerCount = 1;
+			if (vkCreateImageView(*_device, &viewInfo, nullptr, &_transientImages[i].view) != VK_SUCCESS) {
+				Log.FatalError("Vulkan", "Failed to create transient image view " + resource.name + ".");
+			}
+		}
+		Log.Debug("RenderGraph", std::to_string(transients.size()) + " transient images in " + std::to_string(slots.size()) + " allocations.");
+	}
+
+	// Images sharing memory are handed over in pass order, each one's first barrier waits for the previous occupant.
+	std::vector<ResourceId> lastInSlot(_transientMemory.size(), INVALID_RESOURCE);
+	std::vector<size_t> byFirstUse(transients.size());
+	for (size_t i = 0; i < byFirstUse.size(); i++) byFirstUse[i] = i;
+	std::sort(byFirstUse.begin(), byFirstUse.end(), [&](size_t a, size_t b) { return _resources[transients[a]].firstPass < _resources[transients[b]].firstPass; });
+	for (size_t i : byFirstUse) {
+		Resource& resource = _resources[transients[i]];
+		resource.image = _transientImages[i].image;
+		resource.view = _transientImages[i].view;
+		size_t memory = _transientImages[i].memory;
+		resource.aliasPredecessor = lastInSlot[memory];
+		lastInSlot[memory] = transients[i];
+	}
+}
+
+void RenderGraph::destroyTransients()
+{
+	for (TransientImage& transient : _transientImages) {
+		vkDestroyImageView(*_device, transient.view, nullptr);
+		vkDestroyImage(*_device, transient.image, nullptr);
+	}
+	_transientImages.clear();
+	for (Alloc& memory : _transientMemory) {
+		_allocator->freeMemory(&memory);
+	}
+	_transientMemory.clear();
+	_transientHash = 0;
+}
+
+// Moves a resource into the state a usage needs, appending a barrier if one is required. Reads that follow a write
+// in the same layout only wait on the stages that haven't already been synchronised with it, and reads never need to
+// wait on each other.
+void RenderGraph::transition(Resource& resource, ResourceUsage usage, std::vector<VkImageMemoryBarrier2>& barriers)
+{
+	UsageInfo info = getUsageInfo(usage);
+	ResourceState& state = resource.state;
+	bool isWrite = (info.access & (VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+		VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT)) != 0;
+
+	VkImageMemoryBarrier2 barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = resource.image;
+	barrier.subresourceRange = { resource.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+	barrier.oldLayout = state.layout;
+	barrier.newLayout = info.layout;
+	barrier.dstStageMask = info.stages;
+	barrier.dstAccessMask = info.access;
+
+	bool needsBarrier;
+	if (state.layout != info.layout || isWrite) {
+		barrier.srcStageMask = state.writeStages | state.readStages;
+		barrier.srcAccessMask = state.writeAccess;
+		needsBarrier = state.layout != info.layout || barrier.srcStageMask != VK_PIPELINE_STAGE_2_NONE;
+	}
+	else {
+		barrier.srcStageMask = state.writeStages;
+		barrier.srcAccessMask = state.writeAccess;
+		bool unsynchronised = (info.stages & ~state.readStages) != 0 || (info.access & ~state.readAccess) != 0;
+		needsBarrier = state.writeStages != VK_PIPELINE_STAGE_2_NONE && unsynchronised;
+	}
+	if (needsBarrier) barriers.push_back(barrier);
+
+	if (isWrite) {
+		state.writeStages = info.stages;
+		state.writeAccess = info.access;
+		state.readStages = VK_PIPELINE_STAGE_2_NONE;
+		state.readAccess = VK_ACCESS_2_NONE;
+	}
+	else if (state.layout != info.layout) {
+		// The layout transition acts as a write that later reads in other stages must still wait on.
+		state.writeStages = info.stages;
+		state.writeAccess = VK_ACCESS_2_NONE;
+		state.readStages = info.stages;
+		state.readAccess = info.access;
+	}
+	else {
+		state.readStages |= info.stages;
+		state.readAccess |= info.access;
+	}
+	state.layout = info.layout;
+}
+
+void RenderGraph::buildBarriers()
+{
+	for (Resource& resource : _resources) {
+		resource.state = {};
+		if (resource.imported) {
+			resource.state.layout = resource.import.initialLayout;
+			resource.state.writeStages = resource.import.initialStages;
+			resource.state.writeAccess = resource.import.initialAccess;
+		}
+	}
+
+	std::vector<bool> written(_resources.size(), false);
+	std::vector<bool> storeNeeded(_resources.size(), false);
+	for (int32_t p = 0; p < static_cast<int32_t>(_passes.size()); p++) {
+		Pass& pass = _passes[p];
+		pass.barriers.clear();
+		pass.colorAttachments.clear();
+		pass.depthAttachment.reset();
+		if (pass.culled) continue;
+
+		// An aliased image starts out undefined, but must wait for the image that used its memory before it.
+		for (Resource& resource : _resources) {
+			if (resource.firstPass != p || resource.aliasPredecessor == INVALID_RESOURCE) continue;
+			const ResourceState& previous = _resources[resource.aliasPredecessor].state;
+			resource.state.writeStages = previous.writeStages | previous.readStages;
+			resource.state.writeAccess = previous.writeAccess;
+		}
+
+		for (const PassUsage& use : pass.usages) {
+			transition(_resources[use.resource], use.usage, pass.barriers);
+		}
+
+		uint32_t width = UINT32_MAX, height = UINT32_MAX;
+		for (const PassUsage& use : pass.usages) {
+			UsageInfo info = getUsageInfo(use.usage);
+			Resource& resource = _resources[use.resource];
+			if (!info.attachment) {
+				if (use.write) written[use.resource] = true;
+				continue;
+			}
+
+			VkRenderingAttachmentInfo attachment{};
+			attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+			attachment.imageView = resource.view;
+			attachment.imageLayout = info.layout;
+			bool hasContents = written[use.resource] || (resource.imported && resource.import.initialLayout != VK_IMAGE_LAYOUT_UNDEFINED);
+			if (use.clear.has_value()) {
+				attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+				attachment.clearValue = use.clear.value();
+			}
+			else {
+				attachment.loadOp = hasContents ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			}
+			// Resolved below once it's known whether anything after this pass uses the contents.
+			attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			if (use.write) written[use.resource] = true;
+
+			width = std::min(width, resource.extent.width);
+			height = std::min(height, resource.extent.height);
+			if (info.imageUsage == VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) pass.depthAttachment = attachment;
+			else pass.colorAttachments.push_back(attachment);
+		}
+		if (width != UINT32_MAX) pass.renderArea = { { 0, 0 }, { width, height } };
+	}
+
+	// Attachment contents only need storing if a later pass or the graph output uses them.
+	for (ResourceId i = 0; i < _resources.size(); i++) {
+		storeNeeded[i] = _resources[i].imported && _resources[i].import.finalLayout != VK_IMAGE_LAYOUT_UNDEFINED;
+	}
+	for (int32_t p = static_cast<int32_t>(_passes.size()) - 1; p >= 0; p--) {
+		Pass& pass = _passes[p];
+		if (pass.culled) continue;
+		size_t colorIndex = 0;
+		for (const PassUsage& use : pass.usages) {
+			UsageInfo info = getUsageInfo(use.usage);
+			if (!info.attachment) continue;
+			VkRenderingAttachmentInfo& attachment = info.imageUsage == VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT ? pass.depthAttachment.value() : pass.colorAttachments[colorIndex++];
+			if (storeNeeded[use.resource] || !use.write) attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		}
+		for (const PassUsage& use : pass.usages) {
+			if (use.write) storeNeeded[use.resource] = false;
+		}
+		for (const PassUsage& use : pass.usages) {
+			UsageInfo info = getUsageInfo(use.usage);
+			if (!use.write || (info.attachment && !use.clear.has_value())) storeNeeded[use.resource] = true;
+		}
+	}
+
+	_finalBarriers.clear();
+	for (Resource& resource : _resources) {
+		if (!resource.imported || resource.import.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED) continue;
+		if (resource.state.layout == resource.import.finalLayout) continue;
+		VkImageMemoryBarrier2 barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = resource.image;
+		barrier.subresourceRange = { resource.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+		barrier.oldLayout = resource.state.layout;
+		barrier.newLayout = resource.import.finalLayout;
+		barrier.srcStageMask = resource.state.writeStages | resource.state.readStages;
+		barrier.srcAccessMask = resource.state.writeAccess;
+		// Whatever consumes outputs next, such as presentation, waits on a semaphore signalled after all commands.
+		barrier.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+		barrier.dstAccessMask = VK_ACCESS_2_NONE;
+		_finalBarriers.push_back(barrier);
+	}
+}
+
+void RenderGraph::Execute(VkCommandBuffer cmd)
+{
+	if (!_compiled) {
+		Log.Error("RenderGraph", "Attempted to execute a render graph that has not been compiled.");
+		return;
+	}
+
+	for (Pass& pass : _passes) {
+		if (pass.culled) continue;
+
+		if (!pass.barriers.empty()) {
+			VkDependencyInfo dependency{};
+			dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+			dependency.imageMemoryBarrierCount = static_cast<uint32_t>(pass.barriers.size());
+			dependency.pImageMemoryBarriers = pass.barriers.data();
+			vkCmdPipelineBarrier2(cmd, &dependency);
+		}
+
+		bool rendering = !pass.colorAttachments.empty() || pass.depthAttachment.has_value();
+		if (rendering) {
+			VkRenderingInfo renderingInfo{};
+			renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+			renderingInfo.renderArea = pass.renderArea;
+			renderingInfo.layerCount = 1;
+			renderingInfo.colorAttachmentCount = static_cast<uint32_t>(pass.colorAttachments.size());
+			renderingInfo.pColorAttachments = pass.colorAttachments.data();
+			renderingInfo.pDepthAttachment = pass.depthAttachment.has_value() ? &pass.depthAttachment.value() : nullptr;
+			vkCmdBeginRendering(cmd, &renderingInfo);
+		}
+
+		pass.execute(cmd, *this);
+
+		if (rendering) vkCmdEndRendering(cmd);
+	}
+
+	if (!_finalBarriers.empty()) {
+		VkDependencyInfo dependency{};
+		dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+		dependency.imageMemoryBarrierCount = static_cast<uint32_t>(_finalBarriers.size());
+		dependency.pImageMemoryBarriers = _finalBarriers.data();
+		vkCmdPipelineBarrier2(cmd, &dependency);
+	}
+}
+
+void RenderGraph::Reset()
+{
+	_passes.clear();
+	_resources.clear();
+	_finalBarriers.clear();
+	_compiled = false;
+}
+
+bool RenderGraph::IsCulled(const string& pass) const
+{
+	for (const Pass& p : _passes) {
+		if (p.name == pass) return p.culled;
+	}
+	return true;
+}
+
+RenderGraph::~RenderGraph()
+{
+	destroyTransients();
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <external/vkBootstrap/VkBootstrap.h>
+#include "core/globals.h"
+#include "vkAllocator.h"
+#include <functional>
+#include <optional>
+#include <vector>
+
+using namespace vkAllocator;
+
+// How a pass uses an image. Each usage maps to the pipeline stages, access mask and layout the graph synchronises on.
+enum class ResourceUsage {
+	ColorAttachment,
+	DepthAttachment,
+	DepthRead,
+	SampledFragment,
+	SampledCompute,
+	StorageRead,
+	StorageWrite,
+	TransferSrc,
+	TransferDst,
+};
+
+// A frame graph. Passes declare the images they read and write, and Compile works out the order dependent work needs:
+// passes that contribute nothing to an output are culled, transient images whose lifetimes don't overlap share memory,
+// and the minimal set of synchronization2 barriers is placed between passes. Passes that use attachments are wrapped
+// in dynamic rendering, with load and store ops derived from how the attachment is used by the rest of the graph.
+//
+// The graph is rebuilt every frame with Reset/AddPass/Compile. Transient images are kept between compiles and only
+// recreated when the set of transients changes, so a single graph must not be recompiled while the GPU may still be
+// executing its last Execute. The renderer keeps one graph per frame in flight for this reason.
+class RenderGraph {
+	public:
+	using ResourceId = uint32_t;
+	static constexpr ResourceId INVALID_RESOURCE = UINT32_MAX;
+
+	// An image owned by the graph, which only lives for the duration of the frame.
+	struct ImageDesc {
+		VkFormat format;
+		VkExtent2D extent;
+		// Usage the passes don't imply, the graph adds the rest itself.
+		VkImageUsageFlags extraUsage = 0;
+	};
+
+	// An image owned outside of the graph, such as a swapchain image. The initial state describes the last use before the
+	// graph runs. If finalLayout is set the image is an output of the graph: passes that contribute to it are never
+	// culled, and it is left in finalLayout once the graph has executed.
+	struct ImportedImage {
+		VkImage image;
+		VkImageView view;
+		VkFormat format;
+		VkExtent2D extent;
+		VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		VkPipelineStageFlags2 initialStages = VK_PIPELINE_STAGE_2_NONE;
+		VkAccessFlags2 initialAccess = VK_ACCESS_2_NONE;
+		VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	};
+
+	using ExecuteFunc = std::function<void(VkCommandBuffer, const RenderGraph&)>;
+
+	private:
+	struct PassUsage {
+		ResourceId resource;
+		ResourceUsage usage;
+		bool write;
+		std::optional<VkClearValue> clear;
+	};
+
+	struct Pass {
+		string name;
+		std::vector<PassUsage> usages{};
+		bool sideEffects = false;
+		ExecuteFunc execute;
+
+		// Filled in by Compile.
+		bool culled = false;
+		std::vector<VkImageMemoryBarrier2> barriers{};
+		std::vector<VkRenderingAttachmentInfo> colorAttachments{};
+		std::optional<VkRenderingAttachmentInfo> depthAttachment{};
+		VkRect2D renderArea{};
+	};
+
+	// Synchronisation state of a resource while walking the passes in execution order.
+	struct ResourceState {
+		VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+		VkPipelineStageFlags2 writeStages = VK_PIPELINE_STAGE_2_NONE;
+		VkAccessFlags2 writeAccess = VK_ACCESS_2_NONE;
+		// Stages and accesses that have already been synchronised with the last write.
+		VkPipelineStageFlags2 readStages = VK_PIPELINE_STAGE_2_NONE;
+		VkAccessFlags2 readAccess = VK_ACCESS_2_NONE;
+	};
+
+	struct Resource {
+		string name;
+		bool imported;
+		VkImage image = VK_NULL_HANDLE;
+		VkImageView view = VK_NULL_HANDLE;
+		VkFormat format;
+		VkExtent2D extent;
+		VkImageAspectFlags aspect;
+		VkImageUsageFlags usage = 0;
+		ImportedImage import{};
+
+		// Filled in by Compile.
+		int32_t firstPass = -1;
+		int32_t lastPass = -1;
+		ResourceId aliasPredecessor = INVALID_RESOURCE;
+		ResourceState state{};
+	};
+
+	// Transient images and the memory they alias, kept between compiles.
+	struct TransientImage {
+		VkImage image;
+		VkImageView view;
+		size_t memory;
+	};
+
+	vkb::Device* _device;
+	Allocator* _allocator;
+	std::vector<Pass> _passes{};
+	std::vector<Resource> _resources{};
+	std::vector<VkImageMemoryBarrier2> _finalBarriers{};
+	bool _compiled = false;
+
+	std::vector<TransientImage> _transientImages{};
+	std::vector<Alloc> _transientMemory{};
+	uint64_t _transientHash = 0;
+
+	void cullPasses();
+	void computeLifetimes();
+	void realiseTransients();
+	void destroyTransients();
+	void buildBarriers();
+	void transition(Resource& resource, ResourceUsage usage, std::vector<VkImageMemoryBarrier2>& barriers);
+
+	public:
+	// Records the resources used by a pass while it is being added.
+	class PassBuilder {
+		friend class RenderGraph;
+		Pass& _pass;
+		PassBuilder(Pass& pass) : _pass(pass) {}
+
+		public:
+		void Read(ResourceId resource, ResourceUsage usage);
+		// Attachments that aren't cleared keep the contents written by earlier passes.
+		void Write(ResourceId resource, ResourceUsage usage, std::optional<VkClearValue> clear = {});
+		// The pass has effects outside of the graph and must never be culled.
+		void SetSideEffects() { _pass.sideEffects = true; }
+	};
+
+	RenderGraph(vkb::Device* device, Allocator* allocator);
+
+	ResourceId CreateImage(string name, ImageDesc desc);
+	ResourceId ImportImage(string name, ImportedImage image);
+	void AddPass(string name, std::function<void(PassBuilder&)> setup, ExecuteFunc execute);
+
+	void Compile();
+	void Execute(VkCommandBuffer cmd);
+	// Clears passes and resources so that the graph can be rebuilt for the next frame.
+	void Reset();
+
+	VkImage GetImage(ResourceId resource) const { return _resources[resource].image; }
+	VkImageView GetImageView(ResourceId resource) const { return _resources[resource].view; }
+	VkExtent2D GetExtent(ResourceId resource) const { return _resources[resource].extent; }
+	bool IsCulled(const string& pass) const;
+
+	~RenderGraph();
+};
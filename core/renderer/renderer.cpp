@@ -13,6 +13,7 @@
 void Renderer::Init(GLFWwindow* window) {
 	_window = window;
 	initVulkan();
+	_initialised = true;
 	Log.Info("Renderer", "Vulkan: Init Done");
 }
 
@@ -35,7 +36,7 @@ void Renderer::initImGUI()
 	init_info.Queue = queues[QueueType::graphics];
 	init_info.DescriptorPoolSize = IMGUI_IMPL_VULKAN_MINIMUM_IMAGE_SAMPLER_POOL_SIZE+2;
 	init_info.MinImageCount = 2;
-	init_info.ImageCount = 2;
+	init_info.ImageCount = static_cast<uint32_t>(swapchainImages.size());
 	init_info.UseDynamicRendering = true;
 	init_info.PipelineRenderingCreateInfo = { .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO };
 	init_info.PipelineRenderingCreateInfo.colorAttachmentCount = 1;
@@ -53,16 +54,20 @@ void Renderer::initVulkan() {
 	createCommandPools();
 
 	_allocator = new Allocator(&_instance.instance, &_physicalDevice.physical_device, &_device.device);
+	_uploadManager = new UploadManager(_allocator, &_device, queues[QueueType::transfer], commandPools[QueueType::transfer],
+		_device.get_dedicated_queue_index(QueueType::transfer).value(), _device.get_queue_index(QueueType::graphics).value());
+	_pipelineCache = new PipelineCache(&_device, &_physicalDevice);
+	_pipelineRegistry = new PipelineRegistry(&_device, _pipelineCache->Get());
+	_transientAllocator = new TransientAllocator(_allocator, &_physicalDevice, MAX_FRAMES_IN_FLIGHT);
+	createBindless();
 	
 	createSwapchain();
 	createFrameObjects();
 	createVertexBuffer();
 	createIndexBuffer();
 
-	createRenderPass();
 	createDescriptorAllocator();
 	createGraphicsPipeline();
-	createFramebuffers();
 
 	initImGUI();
 }
@@ -85,14 +90,45 @@ void Renderer::ProcessFrame() {
 	ImGui::Render();
 	ImGui::UpdatePlatformWindows();
 	ImGui::RenderPlatformWindowsDefault();
+}
+
+void Renderer::SetFramesInFlight(uint32_t count) {
+	count = std::clamp(count, 2u, MAX_FRAMES_IN_FLIGHT);
+	if (count == _framesInFlight) return;
+
+	Log.Info("Renderer", "Frames in flight: " + std::to_string(count));
+	if (!_initialised) {
+		_framesInFlight = count;
+		return;
+	}
+
+	// Every frame slot is created up front, so changing the count only needs the GPU to drain
+	// so that the ring can restart from a known state.
 	VK_ASSERT(vkDeviceWaitIdle(_device));
+	_deletionQueue.Flush();
+	_framesInFlight = count;
+	frameNum = 0;
+	recreateSwapChain();
+}
+
+void Renderer::SetBindless(bool enabled) {
+	if (_initialised) {
+		Log.Error("Renderer", "Bindless can only be enabled before the renderer is initialised.");
+		return;
+	}
+	_useBindless = enabled;
 }
 
 void Renderer::drawFrame() {
 
-	FrameData current_frame = get_current_frame();
+	FrameData& current_frame = get_current_frame();
 	VK_ASSERT(vkWaitForFences(_device, 1, &current_frame.renderFence, VK_TRUE, UINT64_MAX));
 
+	// This slot's fence has signalled, so every frame up to the one that last used it has retired.
+	if (frameNum >= _framesInFlight) {
+		_deletionQueue.Retire(frameNum - _framesInFlight);
+	}
+
 	uint32_t imageIndex;
 	VkResult result = vkAcquireNextImageKHR(_device, _swapchain, UINT64_MAX, current_frame.imageSemaphore, VK_NULL_HANDLE, &imageIndex);
 
@@ -105,6 +141,8 @@ void Renderer::drawFrame() {
 	}
 	vkResetFences(_device, 1, &current_frame.renderFence);
 	vkResetCommandBuffer(current_frame.commandBuffer, 0);
+	_transientAllocator->BeginFrame(frameNum % _framesInFlight);
+	updateUniformBuffer(current_frame);
 
 	VkCommandBufferBeginInfo beginInfo{};
 	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -112,25 +150,17 @@ void Renderer::drawFrame() {
 		Log.FatalError("Vulkan", "Failed to begin recording command buffer.");
 	}
 
-	VkRenderPassBeginInfo renderPassInfo{};
-	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-	renderPassInfo.renderPass = renderPass;
-	renderPassInfo.framebuffer = swapchainImages[imageIndex].framebuffer;
-
-	renderPassInfo.renderArea.offset = { 0, 0 };
-	renderPassInfo.renderArea.extent = _swapchain.extent;
-
-	VkClearValue clearColor = { {{0.0f, 0.0f, 0.0f, 1.0f}} };
-	renderPassInfo.clearValueCount = 1;
-	renderPassInfo.pClearValues = &clearColor;
-
-	vkCmdBeginRenderPass(current_frame.commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+	// Submit this frame's uploads, and take ownership of anything uploaded since the last frame.
+	_uploadManager->Flush();
+	UploadManager::PendingAcquire uploads = _uploadManager->RecordAcquireBarriers(current_frame.commandBuffer);
 
-	recordFrameCmdBuffer(current_frame.commandBuffer, imageIndex);
+	RenderGraph& graph = *current_frame.renderGraph;
+	graph.Reset();
+	buildFrameGraph(graph, imageIndex);
+	graph.Compile();
+	graph.Execute(current_frame.commandBuffer);
 
-	updateUniformBuffer(frameNum % MAX_FRAMES_IN_FLIGHT);
-	
-	vkCmdEndRenderPass(current_frame.commandBuffer);
+	_transientAllocator->Flush();
 	if (vkEndCommandBuffer(current_frame.commandBuffer) != VK_SUCCESS) {
 		Log.FatalError("Vulkan", "Failed to record command buffer.");
 	}
@@ -138,16 +168,23 @@ void Renderer::drawFrame() {
 	VkSubmitInfo submitInfo{};
 	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-	VkSemaphore waitSemaphores[] = { current_frame.imageSemaphore };
-	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-	submitInfo.waitSemaphoreCount = 1;
+	VkSemaphore waitSemaphores[] = { current_frame.imageSemaphore, _uploadManager->GetTimelineSemaphore() };
+	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, uploads.waitStages };
+	uint64_t waitValues[] = { 0, uploads.waitValue };
+	submitInfo.waitSemaphoreCount = uploads.waitValue != 0 ? 2 : 1;
 	submitInfo.pWaitSemaphores = waitSemaphores;
 	submitInfo.pWaitDstStageMask = waitStages;
 
+	VkTimelineSemaphoreSubmitInfo timelineInfo{};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timelineInfo.waitSemaphoreValueCount = submitInfo.waitSemaphoreCount;
+	timelineInfo.pWaitSemaphoreValues = waitValues;
+	submitInfo.pNext = &timelineInfo;
+
 	submitInfo.commandBufferCount = 1;
 	submitInfo.pCommandBuffers = &current_frame.commandBuffer;
 
-	VkSemaphore signalSemaphores[] = { current_frame.renderSemaphore };
+	VkSemaphore signalSemaphores[] = { swapchainImages[imageIndex].renderSemaphore };
 	submitInfo.signalSemaphoreCount = 1;
 	submitInfo.pSignalSemaphores = signalSemaphores;
 
@@ -177,7 +214,7 @@ void Renderer::drawFrame() {
 	frameNum++;
 }
 
-void Renderer::updateUniformBuffer(uint32_t current) {
+void Renderer::updateUniformBuffer(FrameData& frame) {
 	static auto startTime = std::chrono::high_resolution_clock::now();
 
 	auto currentTime = std::chrono::high_resolution_clock::now();
@@ -187,36 +224,45 @@ void Renderer::updateUniformBuffer(uint32_t current) {
 	ubo.view = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
 	ubo.proj = glm::perspective(glm::radians(45.0f), _swapchain.extent.width / (float)_swapchain.extent.height, 0.1f, 10.0f);
 	ubo.proj[1][1] *= -1;
-	memcpy(get_current_frame().uniformBuffer.info.pMappedData, &ubo, sizeof(ubo));
+	frame.uniformOffset = static_cast<uint32_t>(_transientAllocator->Push(ubo).offset);
 
 }
 
-void Renderer::cleanupSwapChain(bool destroySwapchain) {
+void Renderer::cleanupSwapChain() {
 
 	for (size_t i = 0; i < swapchainImages.size(); i++)
 	{
-		vkDestroyFramebuffer(_device, swapchainImages[i].framebuffer, nullptr);
 		vkDestroyImageView(_device, swapchainImages[i].imageView, nullptr);
-
+		vkDestroySemaphore(_device, swapchainImages[i].renderSemaphore, nullptr);
 	}
 
-	if (destroySwapchain) vkb::destroy_swapchain(_swapchain);
+	vkb::destroy_swapchain(_swapchain);
 }
 
 void Renderer::Cleanup() {
+	VK_ASSERT(vkDeviceWaitIdle(_device));
+	_deletionQueue.Flush();
 	cleanupSwapChain();
 
-	vkDestroyPipeline(_device, graphicsPipeline, nullptr);
-	vkDestroyPipelineLayout(_device, pipelineLayout, nullptr);
-	vkDestroyRenderPass(_device, renderPass, nullptr);
-
-	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
-	{
-		_allocator->destroy(&_frames[i].uniformBuffer);
-	}
+	delete _pipelineRegistry;
+	_pipelineCache->Save();
+	delete _pipelineCache;
 
 	delete _descriptorAllocator;
+	delete _transientAllocator;
+
+	if (_bindless) {
+		ResourceLoader::RemoveLoadListener(_resourceListener);
+		for (ImageAlloc* texture : _textures) {
+			vkDestroyImageView(_device, texture->imageView, nullptr);
+			_allocator->destroy(texture);
+			delete texture;
+		}
+		vkDestroySampler(_device, _defaultSampler, nullptr);
+		delete _bindless;
+	}
 
+	delete _uploadManager;
 	_allocator->destroy(&vertexBuffer);
 	_allocator->destroy(&indexBuffer);
 
@@ -246,7 +292,7 @@ void Renderer::Cleanup() {
 }
 
 void Renderer::createSwapchain() {
-	uint32_t imageCount = MAX_FRAMES_IN_FLIGHT;
+	uint32_t imageCount = _framesInFlight;
 	vkb::SwapchainBuilder swapchain_builder{ _device };
 	swapchain_builder.use_default_format_selection().use_default_present_mode_selection().use_default_image_usage_flags();
 	swapchain_builder.set_desired_min_image_count(imageCount);
@@ -260,9 +306,6 @@ void Renderer::createSwapchain() {
 		Log.FatalError("Vulkan", "Failed to create swapchain.");
 	}
 
-	if (_swapchain != nullptr) {
-		vkb::destroy_swapchain(_swapchain);
-	}
 	_swapchain = swap_ret.value();
 
 	// Setup swapchain images
@@ -294,6 +337,12 @@ void Renderer::createSwapchain() {
 			Log.FatalError("Vulkan", "Failed to create swapchain image views.");
 		}
 
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		if (vkCreateSemaphore(_device, &semaphoreInfo, nullptr, &swapchainImages[i].renderSemaphore) != VK_SUCCESS) {
+			Log.FatalError("Vulkan", "Failed to create swapchain image semaphore.");
+		}
+
 	}
 }
 
@@ -306,55 +355,18 @@ void Renderer::recreateSwapChain() {
 		glfwWaitEvents();
 	}
 
-	vkDeviceWaitIdle(_device);
-	cleanupSwapChain(false);
+	// Frames still in flight may be using the old swapchain, so its destruction waits for them to retire.
+	deferDestroy([this, oldImages = swapchainImages, oldSwapchain = _swapchain]() {
+		for (const SwapchainImage& image : oldImages) {
+			vkDestroyImageView(_device, image.imageView, nullptr);
+			vkDestroySemaphore(_device, image.renderSemaphore, nullptr);
+		}
+		vkb::destroy_swapchain(oldSwapchain);
+	});
 	createSwapchain();
-	createFramebuffers();
 }
 
 
-void Renderer::createRenderPass() {
-	VkAttachmentDescription colorAttachment{};
-	colorAttachment.format = _swapchain.image_format;
-	colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-	VkAttachmentReference colorAttachmentRef{};
-	colorAttachmentRef.attachment = 0;
-	colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-	VkSubpassDescription subpass{};
-	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-	subpass.colorAttachmentCount = 1;
-	subpass.pColorAttachments = &colorAttachmentRef;
-
-	VkRenderPassCreateInfo renderPassInfo{};
-	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-	renderPassInfo.attachmentCount = 1;
-	renderPassInfo.pAttachments = &colorAttachment;
-	renderPassInfo.subpassCount = 1;
-	renderPassInfo.pSubpasses = &subpass;
-
-	VkSubpassDependency dependency{};
-	dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-	dependency.dstSubpass = 0;
-	dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-	dependency.srcAccessMask = 0;
-	dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-	dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-	renderPassInfo.dependencyCount = 1;
-	renderPassInfo.pDependencies = &dependency;
-
-	if (vkCreateRenderPass(_device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS) {
-		Log.FatalError("Vulkan", "Failed to create render pass.");
-	}
-}
-
 void Renderer::createGraphicsPipeline() {
 	resources::Shader* vertShader = ResourceLoader::Load<resources::Shader>("shaders/shader.vert");
 	resources::Shader* fragShader = ResourceLoader::Load<resources::Shader>("shaders/shader.frag");
@@ -362,8 +374,8 @@ void Renderer::createGraphicsPipeline() {
 	GraphicsPipelineBuilder pipeline;
 	auto attributeDescs = Vertex::getAttributeDescriptions();
 
-	pipeline.AddShaderStage(VK_SHADER_STAGE_VERTEX_BIT, vertShader->GetShaderModule(_device));
-	pipeline.AddShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT, fragShader->GetShaderModule(_device));
+	pipeline.AddShaderStage(VK_SHADER_STAGE_VERTEX_BIT, vertShader->GetShaderModule(_device), vertShader->GetShaderSPIRV());
+	pipeline.AddShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT, fragShader->GetShaderModule(_device), fragShader->GetShaderSPIRV());
 	pipeline.SetDynamicStates(0, {VK_DYNAMIC_STATE_VIEWPORT,VK_DYNAMIC_STATE_SCISSOR});
 	pipeline.SetVertexInputState(0, {attributeDescs[0], attributeDescs[1]}, {Vertex::getBindingDescription()});
 	pipeline.SetInputAssemblyState(0, false, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
@@ -376,31 +388,17 @@ void Renderer::createGraphicsPipeline() {
 	colorBlendAttachment.blendEnable = VK_FALSE;
 	
 	pipeline.SetColorBlendState(0, false, VK_LOGIC_OP_MAX_ENUM, { colorBlendAttachment });
-	pipeline.SetPipelineLayout(0, {}, { _descriptorAllocator->GetLayoutObj()});
+	if (_bindless) {
+		pipeline.SetPipelineLayout(0, { BindlessRegistry::GetPushConstantRange() }, { _descriptorAllocator->GetLayoutObj(), _bindless->GetLayout() });
+	}
+	else {
+		pipeline.SetPipelineLayout(0, {}, { _descriptorAllocator->GetLayoutObj()});
+	}
 
-	pipelineLayout = pipeline.BuildLayout(&_device);
-	graphicsPipeline = pipeline.BuildPipeline(&_device, renderPass);
-}
+	pipeline.SetRenderingFormats({ _swapchain.image_format });
 
-void Renderer::createFramebuffers() {
-	for (size_t i = 0; i < swapchainImages.size(); i++) {
-		VkImageView attachments[] = {
-			swapchainImages[i].imageView
-		};
-
-		VkFramebufferCreateInfo framebufferInfo{};
-		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-		framebufferInfo.renderPass = renderPass;
-		framebufferInfo.attachmentCount = 1;
-		framebufferInfo.pAttachments = attachments;
-		framebufferInfo.width = _swapchain.extent.width;
-		framebufferInfo.height = _swapchain.extent.height;
-		framebufferInfo.layers = 1;
-
-		if (vkCreateFramebuffer(_device, &framebufferInfo, nullptr, &swapchainImages[i].framebuffer) != VK_SUCCESS) {
-			Log.FatalError("Vulkan", "Failed to create framebuffer.");
-		}
-	}
+	pipelineLayout = _pipelineRegistry->GetOrCreateLayout(pipeline);
+	graphicsPipeline = _pipelineRegistry->CompileBatch({ pipeline }, VK_NULL_HANDLE)[0];
 }
 
 void Renderer::createCommandPools() {
@@ -414,7 +412,7 @@ void Renderer::createCommandPools() {
 	VkCommandPoolCreateInfo transferPoolInfo{};
 	transferPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 	transferPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-	transferPoolInfo.queueFamilyIndex = _device.get_queue_index(QueueType::transfer).value();
+	transferPoolInfo.queueFamilyIndex = _device.get_dedicated_queue_index(QueueType::transfer).value();
 	if (vkCreateCommandPool(_device, &transferPoolInfo, nullptr, &commandPools[QueueType::transfer]) != VK_SUCCESS) {
 		Log.FatalError("Vulkan", "Failed to create command pool.");
 	}
@@ -424,6 +422,7 @@ void Renderer::createFrameObjects() {
 	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
 	{
 		_frames[i]._device = &_device;
+		_frames[i].renderGraph = new RenderGraph(&_device, _allocator);
 		// Command buffer creation
 		VkCommandBufferAllocateInfo allocInfo{};
 		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -435,12 +434,6 @@ void Renderer::createFrameObjects() {
 			Log.FatalError("Vulkan", "Failed to allocate command buffer.");
 		}
 
-		// Uniform buffer creation
-
-		VkDeviceSize bufferSize = sizeof(UniformBufferObject);
-		_allocator->createBuffer(&_frames[i].uniformBuffer, bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
-
-
 		// Semaphore and fence creation
 
 		VkSemaphoreCreateInfo semaphoreInfo{};
@@ -450,7 +443,6 @@ void Renderer::createFrameObjects() {
 		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
 		fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 		if (vkCreateSemaphore(_device, &semaphoreInfo, nullptr, &_frames[i].imageSemaphore) != VK_SUCCESS ||
-			vkCreateSemaphore(_device, &semaphoreInfo, nullptr, &_frames[i].renderSemaphore) != VK_SUCCESS ||
 			vkCreateFence(_device, &fenceInfo, nullptr, &_frames[i].renderFence) != VK_SUCCESS) {
 
 			Log.FatalError("Vulkan", "Failed to create frame synchronization objects.");
@@ -459,10 +451,36 @@ void Renderer::createFrameObjects() {
 	}
 }
 
-void Renderer::recordFrameCmdBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+// The frame is currently a single pass drawing straight into the swapchain image. Further passes are added here,
+// and the graph takes care of ordering, culling and synchronising them.
+void Renderer::buildFrameGraph(RenderGraph& graph, uint32_t imageIndex) {
+	RenderGraph::ImportedImage backbufferImage{};
+	backbufferImage.image = swapchainImages[imageIndex].image;
+	backbufferImage.view = swapchainImages[imageIndex].imageView;
+	backbufferImage.format = _swapchain.image_format;
+	backbufferImage.extent = _swapchain.extent;
+	// The acquire semaphore is waited on at the colour output stage, so the first transition must happen after it.
+	backbufferImage.initialStages = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+	backbufferImage.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	RenderGraph::ResourceId backbuffer = graph.ImportImage("backbuffer", backbufferImage);
+
+	VkClearValue clearColor = { {{0.0f, 0.0f, 0.0f, 1.0f}} };
+	graph.AddPass("main", [&](RenderGraph::PassBuilder& pass) {
+		pass.Write(backbuffer, ResourceUsage::ColorAttachment, clearColor);
+	}, [this](VkCommandBuffer cmd, const RenderGraph&) {
+		recordFrameCmdBuffer(cmd);
+	});
+}
 
+void Renderer::recordFrameCmdBuffer(VkCommandBuffer commandBuffer) {
+	// There is no fallback pipeline yet, so skip drawing until the real one has compiled.
+	if (!graphicsPipeline.IsReady()) return;
+	VkPipeline pipeline = graphicsPipeline.Get();
+	if (pipeline == VK_NULL_HANDLE) {
+		Log.FatalError("Vulkan", "Failed to build graphics pipeline.");
+	}
 
-	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 
 	VkViewport viewport{};
 	viewport.x = 0.0f;
@@ -482,7 +500,9 @@ void Renderer::recordFrameCmdBuffer(VkCommandBuffer commandBuffer, uint32_t imag
 	VkDeviceSize offsets[] = { 0 };
 	vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
 	vkCmdBindIndexBuffer(commandBuffer, indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT16);
-	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &_frames[frameNum % MAX_FRAMES_IN_FLIGHT].descriptorSet, 0, nullptr);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &_uniformSet, 1, &get_current_frame().uniformOffset);
+	// Every texture, buffer and sampler is reachable through this one set, draws select theirs with push constants.
+	if (_bindless) _bindless->Bind(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1);
 
 	vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
 }
@@ -546,8 +566,13 @@ void Renderer::createInstanceAndDevice() {
 
 	VkPhysicalDeviceVulkan13Features required_features{};
 	required_features.dynamicRendering = true;
+	required_features.synchronization2 = true;
 	device_selector.set_required_features_13(required_features);
 
+	VkPhysicalDeviceVulkan12Features required_features_12{};
+	required_features_12.timelineSemaphore = true;
+	device_selector.set_required_features_12(required_features_12);
+
 
 	auto pdevice_ret = device_selector.select();
 	if (!pdevice_ret) {
@@ -555,10 +580,14 @@ void Renderer::createInstanceAndDevice() {
 	}
 
 	_physicalDevice = pdevice_ret.value();
+	if (_useBindless && !BindlessRegistry::RequestFeatures(_physicalDevice)) {
+		Log.Warn("Vulkan", "Descriptor indexing is not supported, falling back to bound descriptor sets.");
+		_useBindless = false;
+	}
 
 	// Create logical device
 
-	vkb::DeviceBuilder device_builder(pdevice_ret.value());
+	vkb::DeviceBuilder device_builder(_physicalDevice);
 	auto dev_ret = device_builder.build();
 	if (!dev_ret) {
 		// error
@@ -613,61 +642,106 @@ void Renderer::submitOneTimeCommandBuffer(VkCommandBuffer buffer, QueueType queu
 
 void Renderer::createVertexBuffer() {
 	VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
-	BufferAlloc stagingBuffer;
-	_allocator->createBuffer(&stagingBuffer, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT|VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
-		
-	_allocator->copyIntoAllocation(&stagingBuffer, (void*)vertices.data(), 0, bufferSize);
-
-	_allocator->createBuffer(&vertexBuffer, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 0, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
-
-	VkCommandBuffer commandBuffer = createOneTimeCommandBuffer(QueueType::transfer);
-	_allocator->copyBufferToBufferCmd(commandBuffer, &stagingBuffer, &vertexBuffer, bufferSize);
-	submitOneTimeCommandBuffer(commandBuffer, QueueType::transfer);
-
-	_allocator->destroy(&stagingBuffer);
+	_allocator->createBuffer(&vertexBuffer, bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, 0, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+	_uploadManager->UploadBuffer(&vertexBuffer, vertices.data(), bufferSize, 0, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
 }
 
 void Renderer::createIndexBuffer() {
 	VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
-	BufferAlloc stagingBuffer;
-	_allocator->createBuffer(&stagingBuffer, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
-
-	_allocator->copyIntoAllocation(&stagingBuffer, (void*)indices.data(), 0, bufferSize);
-
-	_allocator->createBuffer(&indexBuffer, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 0, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
-	VkCommandBuffer commandBuffer = createOneTimeCommandBuffer(QueueType::transfer);
-	_allocator->copyBufferToBufferCmd(commandBuffer, &stagingBuffer, &indexBuffer, bufferSize);
-	submitOneTimeCommandBuffer(commandBuffer, QueueType::transfer);
-	_allocator->destroy(&stagingBuffer);
+	_allocator->createBuffer(&indexBuffer, bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 0, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+	_uploadManager->UploadBuffer(&indexBuffer, indices.data(), bufferSize, 0, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT);
 }
 
 void Renderer::createDescriptorAllocator() {
 	VkDescriptorSetLayoutBinding binding{};
 	binding.descriptorCount = 1;
-	binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
 	binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 	
 	_descriptorAllocator = new DescriptorAllocator(_device, {binding});
-	_descriptorAllocator->CreatePool(MAX_FRAMES_IN_FLIGHT);
+	_descriptorAllocator->CreatePool(1);
+	_uniformSet = _descriptorAllocator->AllocateDescriptorSet();
+
+	VkDescriptorBufferInfo bufferInfo{};
+	bufferInfo.buffer = _transientAllocator->GetBuffer();
+	bufferInfo.offset = 0;
+	bufferInfo.range = sizeof(UniformBufferObject);
+	VkWriteDescriptorSet descriptorWrite{};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = _uniformSet;
+	descriptorWrite.dstBinding = 0;
+	descriptorWrite.dstArrayElement = 0;
+	descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+	descriptorWrite.descriptorCount = 1;
+	descriptorWrite.pBufferInfo = &bufferInfo;
+	vkUpdateDescriptorSets(_device, 1, &descriptorWrite, 0, nullptr);
+}
 
-	std::vector<VkDescriptorSet> descriptorSets = _descriptorAllocator->AllocateDescriptorSets(MAX_FRAMES_IN_FLIGHT);
+void Renderer::createBindless() {
+	if (!_useBindless) return;
+	_bindless = new BindlessRegistry(&_device, &_physicalDevice);
+
+	VkSamplerCreateInfo samplerInfo{};
+	samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	samplerInfo.magFilter = VK_FILTER_LINEAR;
+	samplerInfo.minFilter = VK_FILTER_LINEAR;
+	samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+	samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+	if (vkCreateSampler(_device, &samplerInfo, nullptr, &_defaultSampler) != VK_SUCCESS) {
+		Log.FatalError("Vulkan", "Failed to create default sampler.");
+	}
+	// The default sampler is always at index 0.
+	_bindless->AddSampler(_defaultSampler);
 
-	for (size_t i = 0; i < descriptorSets.size(); i++)
-	{
-		_frames[i].descriptorSet = descriptorSets[i];
-		VkDescriptorBufferInfo bufferInfo{};
-		bufferInfo.buffer = _frames[i].uniformBuffer.buffer;
-		bufferInfo.offset = 0;
-		bufferInfo.range = sizeof(UniformBufferObject);
-		VkWriteDescriptorSet descriptorWrite{};
-		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptorWrite.dstSet = _frames[i].descriptorSet;
-		descriptorWrite.dstBinding = 0;
-		descriptorWrite.dstArrayElement = 0;
-		descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		descriptorWrite.descriptorCount = 1;
-		descriptorWrite.pBufferInfo = &bufferInfo;
-		vkUpdateDescriptorSets(_device, 1, &descriptorWrite, 0, nullptr);
-
-	}
-}
\ No newline at end of file
+	_resourceListener = ResourceLoader::AddLoadListener([this](Resource* resource) {
+		resources::Image* image = object_cast<resources::Image>(resource);
+		if (image != nullptr) createTexture(image);
+	});
+}
+
+void Renderer::createTexture(resources::Image* image) {
+	// Pixel data is always decoded to 8 bits per channel. Three channel formats are rarely sampleable, so RGB is expanded to RGBA.
+	const std::vector<uint8_t>& pixels = image->GetPixelData();
+	std::vector<uint8_t> expanded{};
+	const uint8_t* data = pixels.data();
+	VkDeviceSize size = pixels.size();
+	VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+	switch (image->GetChannels()) {
+		case 1:
+			format = VK_FORMAT_R8_UNORM;
+			break;
+		case 2:
+			format = VK_FORMAT_R8G8_UNORM;
+			break;
+		case 3:
+			expanded.resize(pixels.size() / 3 * 4);
+			for (size_t src = 0, dst = 0; src + 2 < pixels.size(); src += 3, dst += 4) {
+				expanded[dst] = pixels[src];
+				expanded[dst + 1] = pixels[src + 1];
+				expanded[dst + 2] = pixels[src + 2];
+				expanded[dst + 3] = 255;
+			}
+			data = expanded.data();
+			size = expanded.size();
+			break;
+	}
+
+	ImageAlloc* texture = new ImageAlloc();
+	Allocator::ImageParams params{};
+	params.type = VK_IMAGE_TYPE_2D;
+	params.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+	params.format = format;
+	params.tiling = VK_IMAGE_TILING_OPTIMAL;
+	params.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+	params.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	params.samples = VK_SAMPLE_COUNT_1_BIT;
+	VkExtent3D extent = { static_cast<uint32_t>(image->GetWidth()), static_cast<uint32_t>(image->GetHeight()), 1 };
+	_allocator->createImage(texture, params, extent, 0, 0, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+	_uploadManager->UploadImage(texture, data, size);
+
+	image->SetBindlessIndex(_bindless->AddImage(texture->imageView));
+	_textures.push_back(texture);
+}
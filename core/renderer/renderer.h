@@ -21,10 +21,19 @@
 
 #include "vkAllocator.h"
 #include "descriptorBuilder.h"
+#include "pipelineCache.h"
+#include "pipelineRegistry.h"
+#include "uploadManager.h"
+#include "deletionQueue.h"
+#include "renderGraph.h"
+#include "bindlessRegistry.h"
+#include "transientAllocator.h"
 #include "utils/uniqueId.h"
 
 using namespace vkAllocator;
-const int32_t MAX_FRAMES_IN_FLIGHT = 2;
+// Upper bound on frames in flight, the number actually used is chosen at runtime with Renderer::SetFramesInFlight.
+const uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+const uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;
 
 using QueueType = vkb::QueueType;
 
@@ -83,24 +92,29 @@ const std::vector<uint16_t> indices = {
 	0, 1, 2, 2, 3, 0
 };
 
+// Objects owned by a single frame in flight. renderFence is signalled when the GPU has finished with the frame,
+// and must be waited on before the command buffer, transient allocator region or render graph are reused.
 struct FrameData {
 	VkCommandBuffer commandBuffer;
-	VkSemaphore imageSemaphore, renderSemaphore;
+	VkSemaphore imageSemaphore;
 	VkFence renderFence;
-	VkDescriptorSet descriptorSet;
-	BufferAlloc uniformBuffer;
+	// Dynamic offset of this frame's UniformBufferObject in the transient allocator.
+	uint32_t uniformOffset = 0;
+	RenderGraph* renderGraph = nullptr;
 	vkb::Device* _device;
 	void Destroy() const {
 		vkDestroySemaphore(*_device, imageSemaphore, nullptr);
-		vkDestroySemaphore(*_device, renderSemaphore, nullptr);
 		vkDestroyFence(*_device, renderFence, nullptr);
+		delete renderGraph;
 	}
 };
 
+// The render semaphore is owned by the swapchain image rather than the frame, as the presentation engine
+// may still be waiting on it after the frame's fence has signalled.
 struct SwapchainImage {
 	VkImage image;
 	VkImageView imageView;
-	VkFramebuffer framebuffer;
+	VkSemaphore renderSemaphore;
 };
 class Renderer {
 	public:
@@ -110,13 +124,23 @@ class Renderer {
 	void BeginFrameProcessing();
 	void ProcessFrame();
 	void Cleanup();
+
+	// Sets how many frames the CPU may record ahead of the GPU, clamped to [2, MAX_FRAMES_IN_FLIGHT].
+	void SetFramesInFlight(uint32_t count);
+	uint32_t GetFramesInFlight() const { return _framesInFlight; }
+	// Requests the bindless descriptor path, used if the device supports descriptor indexing. Must be called before Init.
+	void SetBindless(bool enabled);
+	bool IsBindless() const { return _bindless != nullptr; }
 	private:
 
 	FrameData _frames[MAX_FRAMES_IN_FLIGHT];
-	FrameData& get_current_frame() { return _frames[frameNum % MAX_FRAMES_IN_FLIGHT]; }
+	uint32_t _framesInFlight = DEFAULT_FRAMES_IN_FLIGHT;
+	bool _initialised = false;
+	FrameData& get_current_frame() { return _frames[frameNum % _framesInFlight]; }
 
 	GLFWwindow* _window;
 	Allocator* _allocator = nullptr;
+	UploadManager* _uploadManager = nullptr;
 	vkb::Instance _instance;
 	vkb::PhysicalDevice _physicalDevice;
 	vkb::Device _device;
@@ -124,10 +148,22 @@ class Renderer {
 	vkb::Swapchain _swapchain;
 
 	DescriptorAllocator* _descriptorAllocator = nullptr;
+	TransientAllocator* _transientAllocator = nullptr;
+	// Points at the transient allocator's buffer, so it is written once and selected per draw with a dynamic offset.
+	VkDescriptorSet _uniformSet = nullptr;
+	PipelineCache* _pipelineCache = nullptr;
+	PipelineRegistry* _pipelineRegistry = nullptr;
 	VkPipelineLayout pipelineLayout = nullptr;
-	VkRenderPass renderPass = nullptr;
-	VkPipeline graphicsPipeline = nullptr;
+	PipelineHandle graphicsPipeline;
+
+	bool _useBindless = false;
+	BindlessRegistry* _bindless = nullptr;
+	VkSampler _defaultSampler = nullptr;
+	uint32_t _resourceListener = 0;
+	// GPU copies of images loaded through the ResourceLoader, each registered in the bindless image array.
+	std::vector<ImageAlloc*> _textures{};
 	uint32_t frameNum = 0;
+	DeletionQueue _deletionQueue;
 	
 	std::map<QueueType, VkQueue> queues{};
 	std::map<QueueType, VkCommandPool> commandPools{};
@@ -147,19 +183,23 @@ class Renderer {
 	void createVertexBuffer();
 	void createIndexBuffer();
 
-	void createRenderPass();
 	void createDescriptorAllocator();
 	void createGraphicsPipeline();
-	void createFramebuffers();
+	void createBindless();
+	void createTexture(resources::Image* image);
 
-	void cleanupSwapChain(bool destroySwapchain = true);
+	void cleanupSwapChain();
 	void recreateSwapChain();
 
+	// Destroys objects used by the current frame once it has retired.
+	void deferDestroy(std::function<void()> destroy) { _deletionQueue.Push(frameNum, std::move(destroy)); }
+
 	void drawFrame();
 
 	VkCommandBuffer createOneTimeCommandBuffer(QueueType queue);
 	void submitOneTimeCommandBuffer(VkCommandBuffer buffer, QueueType queue);
 
-	void recordFrameCmdBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
-	void updateUniformBuffer(uint32_t currentImage);
+	void buildFrameGraph(RenderGraph& graph, uint32_t imageIndex);
+	void recordFrameCmdBuffer(VkCommandBuffer commandBuffer);
+	void updateUniformBuffer(FrameData& frame);
 };
\ No newline at end of file
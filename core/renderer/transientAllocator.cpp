@@ -0,0 +1,48 @@
+#include "transientAllocator.h"
+#include <algorithm>
+
+TransientAllocator::TransientAllocator(Allocator* allocator, const vkb::PhysicalDevice* physicalDevice, uint32_t frameCount, VkDeviceSize regionSize)
+{
+	_allocator = allocator;
+	_frameCount = frameCount;
+
+	const VkPhysicalDeviceLimits& limits = physicalDevice->properties.limits;
+	_alignment = std::max(limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment);
+	_regionSize = (regionSize + _alignment - 1) & ~(_alignment - 1);
+
+	VkBufferUsageFlags usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+	_allocator->createBuffer(&_buffer, _regionSize * _frameCount, usage, VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+}
+
+void TransientAllocator::BeginFrame(uint32_t frameIndex)
+{
+	_frameIndex = frameIndex % _frameCount;
+	_head = 0;
+}
+
+TransientAllocator::Allocation TransientAllocator::Allocate(VkDeviceSize size)
+{
+	VkDeviceSize alignedSize = (size + _alignment - 1) & ~(_alignment - 1);
+	VkDeviceSize start = _head.fetch_add(alignedSize);
+	if (start + alignedSize > _regionSize) {
+		Log.FatalError("Vulkan", "Transient allocator region of " + std::to_string(_regionSize) + " bytes exhausted.");
+	}
+
+	Allocation allocation{};
+	allocation.buffer = _buffer.buffer;
+	allocation.offset = _frameIndex * _regionSize + start;
+	allocation.data = static_cast<uint8_t*>(_buffer.info.pMappedData) + allocation.offset;
+	return allocation;
+}
+
+void TransientAllocator::Flush()
+{
+	VkDeviceSize used = std::min(_head.load(), _regionSize);
+	if (used == 0) return;
+	_allocator->flushAllocation(&_buffer, _frameIndex * _regionSize, used);
+}
+
+TransientAllocator::~TransientAllocator()
+{
+	_allocator->destroy(&_buffer);
+}
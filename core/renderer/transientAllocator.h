@@ -0,0 +1,55 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <external/vkBootstrap/VkBootstrap.h>
+#include "core/globals.h"
+#include "vkAllocator.h"
+#include <atomic>
+#include <cstring>
+
+using namespace vkAllocator;
+
+// Scratch GPU memory for uniform and other per-frame data, such as per-object constants. A single persistently mapped
+// buffer is split into a region per frame in flight, allocations bump an offset within the current frame's region, and
+// the region is reset as a whole by BeginFrame once the frame's fence has signalled. Offsets are aligned for use as
+// dynamic uniform or storage buffer offsets, so per-draw data needs no new buffers and no descriptor writes.
+class TransientAllocator {
+	public:
+	struct Allocation {
+		VkBuffer buffer;
+		// Offset from the start of the buffer, usable directly as a dynamic offset.
+		VkDeviceSize offset;
+		void* data;
+	};
+
+	private:
+	Allocator* _allocator;
+	BufferAlloc _buffer;
+	uint32_t _frameCount;
+	VkDeviceSize _regionSize;
+	VkDeviceSize _alignment;
+	uint32_t _frameIndex = 0;
+	// Allocation sizes are rounded up to the alignment, so the head can be bumped from several threads at once.
+	std::atomic<VkDeviceSize> _head = 0;
+
+	public:
+	TransientAllocator(Allocator* allocator, const vkb::PhysicalDevice* physicalDevice, uint32_t frameCount, VkDeviceSize regionSize = 4 * 1024 * 1024);
+
+	// Starts allocating from the region of frameIndex, discarding everything previously allocated from it.
+	void BeginFrame(uint32_t frameIndex);
+	Allocation Allocate(VkDeviceSize size);
+
+	template <typename T>
+	Allocation Push(const T& value) {
+		Allocation allocation = Allocate(sizeof(T));
+		memcpy(allocation.data, &value, sizeof(T));
+		return allocation;
+	}
+
+	// Makes this frame's writes visible to the device. Must be called before the frame is submitted.
+	void Flush();
+
+	VkBuffer GetBuffer() const { return _buffer.buffer; }
+	VkDeviceSize GetAlignment() const { return _alignment; }
+
+	~TransientAllocator();
+};
@@ -0,0 +1,319 @@
+#include "uploadManager.h"
+
+UploadManager::UploadManager(Allocator* allocator, vkb::Device* device, VkQueue transferQueue, VkCommandPool transferPool, uint32_t transferFamily, uint32_t graphicsFamily, VkDeviceSize ringSize)
+{
+	_allocator = allocator;
+	_device = *device;
+	_transferQueue = transferQueue;
+	_commandPool = transferPool;
+	_transferFamily = transferFamily;
+	_graphicsFamily = graphicsFamily;
+	_ringSize = ringSize;
+
+	_allocator->createBuffer(&_ring, _ringSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+
+	VkSemaphoreTypeCreateInfo timelineInfo{};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	timelineInfo.initialValue = 0;
+
+	VkSemaphoreCreateInfo semaphoreInfo{};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	semaphoreInfo.pNext = &timelineInfo;
+	if (vkCreateSemaphore(_device, &semaphoreInfo, nullptr, &_timeline) != VK_SUCCESS) {
+		Log.FatalError("Vulkan", "Failed to create upload timeline semaphore.");
+	}
+}
+
+VkCommandBuffer UploadManager::getRecordingBuffer()
+{
+	if (_recording != VK_NULL_HANDLE) return _recording;
+
+	Retire();
+	if (!_freeCommandBuffers.empty()) {
+		_recording = _freeCommandBuffers.back();
+		_freeCommandBuffers.pop_back();
+	}
+	else {
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandPool = _commandPool;
+		allocInfo.commandBufferCount = 1;
+		if (vkAllocateCommandBuffers(_device, &allocInfo, &_recording) != VK_SUCCESS) {
+			Log.FatalError("Vulkan", "Failed to allocate upload command buffer.");
+		}
+	}
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer(_recording, &beginInfo);
+	return _recording;
+}
+
+bool UploadManager::tryAllocate(VkDeviceSize size, VkDeviceSize& offset)
+{
+	if (_regions.empty()) _head = 0;
+	VkDeviceSize start = (_head + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+
+	// Once the head has wrapped, the last region ends before the first one starts, and the only free space is between them.
+	bool wrapped = !_regions.empty() && _regions.back().end <= _regions.front().start;
+	if (wrapped) {
+		if (start + size > _regions.front().start) return false;
+		offset = start;
+	}
+	else if (start + size <= _ringSize) {
+		offset = start;
+	}
+	else if (size <= (_regions.empty() ? _ringSize : _regions.front().start)) {
+		offset = 0;
+	}
+	else {
+		return false;
+	}
+
+	_head = offset + size;
+	_regions.push_back({ _nextValue, offset, _head });
+	return true;
+}
+
+VkDeviceSize UploadManager::allocateStaging(VkDeviceSize size)
+{
+	VkDeviceSize offset = 0;
+	while (!tryAllocate(size, offset)) {
+		// The oldest region may belong to the batch still being recorded, which has to be submitted before it can complete.
+		if (_regions.front().value >= _nextValue) Flush();
+		waitForValue(_regions.front().value);
+		Retire();
+	}
+	return offset;
+}
+
+void UploadManager::stage(const void* data, VkDeviceSize size, VkBuffer& srcBuffer, VkDeviceSize& srcOffset)
+{
+	if (size > _ringSize) {
+		Log.Debug("UploadManager", "Upload of " + std::to_string(size) + " bytes is larger than the staging ring, using a dedicated staging buffer.");
+		OversizedStaging staging{};
+		staging.value = _nextValue;
+		_allocator->createBuffer(&staging.buffer, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+		_allocator->copyIntoAllocation(&staging.buffer, const_cast<void*>(data), 0, size);
+		_oversized.push_back(staging);
+		srcBuffer = staging.buffer.buffer;
+		srcOffset = 0;
+		return;
+	}
+
+	srcOffset = allocateStaging(size);
+	srcBuffer = _ring.buffer;
+	_allocator->copyIntoAllocation(&_ring, const_cast<void*>(data), srcOffset, size);
+}
+
+void UploadManager::UploadBuffer(BufferAlloc* dst, const void* data, VkDeviceSize size, VkDeviceSize dstOffset, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+	if (size == 0) return;
+
+	VkBuffer srcBuffer;
+	VkDeviceSize srcOffset;
+	stage(data, size, srcBuffer, srcOffset);
+	VkCommandBuffer cmd = getRecordingBuffer();
+
+	VkBufferCopy copyRegion{};
+	copyRegion.srcOffset = srcOffset;
+	copyRegion.dstOffset = dstOffset;
+	copyRegion.size = size;
+	vkCmdCopyBuffer(cmd, srcBuffer, dst->buffer, 1, &copyRegion);
+
+	_unflushedStages |= dstStage;
+	if (!ownershipTransferNeeded()) return;
+
+	VkBufferMemoryBarrier release{};
+	release.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	release.dstAccessMask = 0;
+	release.srcQueueFamilyIndex = _transferFamily;
+	release.dstQueueFamilyIndex = _graphicsFamily;
+	release.buffer = dst->buffer;
+	release.offset = dstOffset;
+	release.size = size;
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &release, 0, nullptr);
+
+	AcquireBarrier acquire{};
+	acquire.isImage = false;
+	acquire.bufferBarrier = release;
+	acquire.bufferBarrier.srcAccessMask = 0;
+	acquire.bufferBarrier.dstAccessMask = dstAccess;
+	acquire.dstStage = dstStage;
+	_unflushedAcquires.push_back(acquire);
+}
+
+void UploadManager::UploadImage(ImageAlloc* dst, const void* data, VkDeviceSize size, VkImageLayout finalLayout, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+	if (size == 0) return;
+
+	VkBuffer srcBuffer;
+	VkDeviceSize srcOffset;
+	stage(data, size, srcBuffer, srcOffset);
+	VkCommandBuffer cmd = getRecordingBuffer();
+
+	VkImageSubresourceRange range{};
+	range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	range.baseMipLevel = 0;
+	range.levelCount = 1;
+	range.baseArrayLayer = 0;
+	range.layerCount = 1;
+
+	VkImageMemoryBarrier toTransfer{};
+	toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	toTransfer.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	toTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	toTransfer.srcAccessMask = 0;
+	toTransfer.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	toTransfer.image = dst->image;
+	toTransfer.subresourceRange = range;
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &toTransfer);
+
+	VkBufferImageCopy region{};
+	region.bufferOffset = srcOffset;
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.mipLevel = 0;
+	region.imageSubresource.baseArrayLayer = 0;
+	region.imageSubresource.layerCount = 1;
+	region.imageOffset = { 0, 0, 0 };
+	region.imageExtent = dst->extent;
+	vkCmdCopyBufferToImage(cmd, srcBuffer, dst->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+	// The transition to the final layout doubles as the release barrier when ownership moves to the graphics queue.
+	VkImageMemoryBarrier release = toTransfer;
+	release.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	release.newLayout = finalLayout;
+	release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	release.dstAccessMask = 0;
+	if (ownershipTransferNeeded()) {
+		release.srcQueueFamilyIndex = _transferFamily;
+		release.dstQueueFamilyIndex = _graphicsFamily;
+	}
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &release);
+	dst->layout = finalLayout;
+
+	_unflushedStages |= dstStage;
+	if (!ownershipTransferNeeded()) return;
+
+	AcquireBarrier acquire{};
+	acquire.isImage = true;
+	acquire.imageBarrier = release;
+	acquire.imageBarrier.srcAccessMask = 0;
+	acquire.imageBarrier.dstAccessMask = dstAccess;
+	acquire.dstStage = dstStage;
+	_unflushedAcquires.push_back(acquire);
+}
+
+uint64_t UploadManager::Flush()
+{
+	if (_recording == VK_NULL_HANDLE) return 0;
+
+	if (vkEndCommandBuffer(_recording) != VK_SUCCESS) {
+		Log.FatalError("Vulkan", "Failed to record upload command buffer.");
+	}
+
+	uint64_t signalValue = _nextValue++;
+	VkTimelineSemaphoreSubmitInfo timelineInfo{};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timelineInfo.signalSemaphoreValueCount = 1;
+	timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext = &timelineInfo;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &_recording;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &_timeline;
+
+	if (vkQueueSubmit(_transferQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+		Log.FatalError("Vulkan", "Failed to submit upload command buffer.");
+	}
+
+	_submissions.push_back({ signalValue, _recording });
+	_recording = VK_NULL_HANDLE;
+
+	_flushedAcquires.insert(_flushedAcquires.end(), _unflushedAcquires.begin(), _unflushedAcquires.end());
+	_unflushedAcquires.clear();
+	_pending.waitValue = signalValue;
+	_pending.waitStages |= _unflushedStages;
+	_unflushedStages = 0;
+
+	return signalValue;
+}
+
+UploadManager::PendingAcquire UploadManager::RecordAcquireBarriers(VkCommandBuffer graphicsCmd)
+{
+	for (const AcquireBarrier& acquire : _flushedAcquires) {
+		if (acquire.isImage) {
+			vkCmdPipelineBarrier(graphicsCmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, acquire.dstStage, 0, 0, nullptr, 0, nullptr, 1, &acquire.imageBarrier);
+		}
+		else {
+			vkCmdPipelineBarrier(graphicsCmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, acquire.dstStage, 0, 0, nullptr, 1, &acquire.bufferBarrier, 0, nullptr);
+		}
+	}
+	_flushedAcquires.clear();
+
+	PendingAcquire pending = _pending;
+	_pending = {};
+	return pending;
+}
+
+uint64_t UploadManager::GetCompletedValue() const
+{
+	uint64_t value = 0;
+	vkGetSemaphoreCounterValue(_device, _timeline, &value);
+	return value;
+}
+
+void UploadManager::waitForValue(uint64_t value) const
+{
+	VkSemaphoreWaitInfo waitInfo{};
+	waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+	waitInfo.semaphoreCount = 1;
+	waitInfo.pSemaphores = &_timeline;
+	waitInfo.pValues = &value;
+	if (vkWaitSemaphores(_device, &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+		Log.FatalError("Vulkan", "Failed to wait on upload timeline semaphore.");
+	}
+}
+
+void UploadManager::Retire()
+{
+	uint64_t completed = GetCompletedValue();
+	while (!_submissions.empty() && _submissions.front().value <= completed) {
+		vkResetCommandBuffer(_submissions.front().commandBuffer, 0);
+		_freeCommandBuffers.push_back(_submissions.front().commandBuffer);
+		_submissions.pop_front();
+	}
+	while (!_regions.empty() && _regions.front().value <= completed) {
+		_regions.pop_front();
+	}
+	while (!_oversized.empty() && _oversized.front().value <= completed) {
+		_allocator->destroy(&_oversized.front().buffer);
+		_oversized.pop_front();
+	}
+}
+
+void UploadManager::WaitIdle() const
+{
+	waitForValue(_nextValue - 1);
+}
+
+UploadManager::~UploadManager()
+{
+	Flush();
+	WaitIdle();
+	Retire();
+	if (!_freeCommandBuffers.empty()) {
+		vkFreeCommandBuffers(_device, _commandPool, static_cast<uint32_t>(_freeCommandBuffers.size()), _freeCommandBuffers.data());
+	}
+	_allocator->destroy(&_ring);
+	vkDestroySemaphore(_device, _timeline, nullptr);
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <external/vkBootstrap/VkBootstrap.h>
+#include "core/globals.h"
+#include "vkAllocator.h"
+#include <deque>
+#include <vector>
+
+using namespace vkAllocator;
+
+// Streams buffer and image data to the GPU through a persistently mapped staging ring on the transfer queue.
+// Uploads are batched into a single submission per Flush, and completion is tracked with a timeline semaphore so that
+// ring space and command buffers are reclaimed without waiting on the queue. When the transfer and graphics queues are in
+// different families, ownership of each destination is released on the transfer queue and acquired on the graphics queue.
+class UploadManager {
+	public:
+	// The state the graphics queue needs to consume uploads flushed since the last call to RecordAcquireBarriers.
+	struct PendingAcquire {
+		uint64_t waitValue = 0;
+		VkPipelineStageFlags waitStages = 0;
+	};
+
+	private:
+	static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+	// A range of the staging ring that is in use until the timeline reaches value.
+	struct RingRegion {
+		uint64_t value;
+		VkDeviceSize start;
+		VkDeviceSize end;
+	};
+
+	struct Submission {
+		uint64_t value;
+		VkCommandBuffer commandBuffer;
+	};
+
+	struct OversizedStaging {
+		uint64_t value;
+		BufferAlloc buffer;
+	};
+
+	// Acquire side of a queue family ownership transfer, recorded on the graphics queue.
+	struct AcquireBarrier {
+		bool isImage;
+		VkBufferMemoryBarrier bufferBarrier;
+		VkImageMemoryBarrier imageBarrier;
+		VkPipelineStageFlags dstStage;
+	};
+
+	Allocator* _allocator;
+	VkDevice _device;
+	VkQueue _transferQueue;
+	VkCommandPool _commandPool;
+	uint32_t _transferFamily;
+	uint32_t _graphicsFamily;
+
+	BufferAlloc _ring;
+	VkDeviceSize _ringSize;
+	VkDeviceSize _head = 0;
+	std::deque<RingRegion> _regions{};
+	std::deque<OversizedStaging> _oversized{};
+
+	VkSemaphore _timeline = VK_NULL_HANDLE;
+	// The value the next Flush will signal.
+	uint64_t _nextValue = 1;
+	std::deque<Submission> _submissions{};
+	std::vector<VkCommandBuffer> _freeCommandBuffers{};
+	VkCommandBuffer _recording = VK_NULL_HANDLE;
+
+	VkPipelineStageFlags _unflushedStages = 0;
+	std::vector<AcquireBarrier> _unflushedAcquires{};
+	std::vector<AcquireBarrier> _flushedAcquires{};
+	PendingAcquire _pending{};
+
+	bool ownershipTransferNeeded() const { return _transferFamily != _graphicsFamily; }
+	VkCommandBuffer getRecordingBuffer();
+	// Reserves size bytes of the ring, flushing and waiting on older uploads if it is full. Returns the offset of the reservation.
+	VkDeviceSize allocateStaging(VkDeviceSize size);
+	bool tryAllocate(VkDeviceSize size, VkDeviceSize& offset);
+	// Copies data into staging memory, using a dedicated buffer if it doesn't fit in the ring.
+	void stage(const void* data, VkDeviceSize size, VkBuffer& srcBuffer, VkDeviceSize& srcOffset);
+	void waitForValue(uint64_t value) const;
+
+	public:
+	UploadManager(Allocator* allocator, vkb::Device* device, VkQueue transferQueue, VkCommandPool transferPool, uint32_t transferFamily, uint32_t graphicsFamily, VkDeviceSize ringSize = 64 * 1024 * 1024);
+
+	// Queues a copy of data into dst. The copy is submitted on the next Flush.
+	void UploadBuffer(BufferAlloc* dst, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0,
+		VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VkAccessFlags dstAccess = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT);
+	// Queues a copy of tightly packed pixel data into the first mip level of dst, leaving it in finalLayout.
+	void UploadImage(ImageAlloc* dst, const void* data, VkDeviceSize size, VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VkAccessFlags dstAccess = VK_ACCESS_SHADER_READ_BIT);
+
+	// Submits every queued upload in a single transfer submission. Returns the timeline value that signals their completion, or 0 if nothing was queued.
+	uint64_t Flush();
+	// Records the acquire half of any ownership transfers into a graphics command buffer. The submission of that command buffer must wait on the timeline semaphore for the returned value.
+	PendingAcquire RecordAcquireBarriers(VkCommandBuffer graphicsCmd);
+	// Releases ring space, staging buffers and command buffers used by completed uploads.
+	void Retire();
+	// Blocks until every flushed upload has completed.
+	void WaitIdle() const;
+
+	VkSemaphore GetTimelineSemaphore() const { return _timeline; }
+	uint64_t GetCompletedValue() const;
+
+	~UploadManager();
+};
@@ -42,7 +42,10 @@ void Allocator::createImage(ImageAlloc* alloc, ImageParams params, VkExtent3D ex
 		return;
 	}
 	VkImageCreateInfo imageInfo{};
-	imageInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageInfo.imageType = params.type;
+	imageInfo.mipLevels = 1;
+	imageInfo.arrayLayers = 1;
 	imageInfo.usage = params.usage;
 	imageInfo.format = params.format;
 	imageInfo.tiling = params.tiling;
@@ -134,6 +137,38 @@ void Allocator::copyFromAllocation(Alloc* allocation, void** data, VkDeviceSize
 	vmaCopyAllocationToMemory(_allocator, allocation->alloc, offset, data, size);
 }
 
+void Allocator::allocateMemory(Alloc* alloc, const VkMemoryRequirements& requirements, VkMemoryPropertyFlags requiredFlags) const
+{
+	if (alloc->inUse) {
+		Log.Error("VMA", "Attempted to allocate memory using an Alloc object that is already in use.");
+		return;
+	}
+	VmaAllocationCreateInfo memoryInfo{};
+	memoryInfo.requiredFlags = requiredFlags;
+
+	alloc->inUse = true;
+	if (vmaAllocateMemory(_allocator, &requirements, &memoryInfo, &alloc->alloc, &alloc->info) != VK_SUCCESS) {
+		Log.FatalError("VMA", "Failed to allocate memory.");
+	}
+}
+
+void Allocator::bindImageMemory(Alloc* alloc, VkImage image) const
+{
+	vmaBindImageMemory(_allocator, alloc->alloc, image);
+}
+
+void Allocator::freeMemory(Alloc* alloc) const
+{
+	if (alloc->mapped) unmapMemory(alloc);
+	vmaFreeMemory(_allocator, alloc->alloc);
+	alloc->inUse = false;
+}
+
+void Allocator::flushAllocation(Alloc* allocation, VkDeviceSize offset, VkDeviceSize size) const
+{
+	vmaFlushAllocation(_allocator, allocation->alloc, offset, size);
+}
+
 void Allocator::mapMemory(Alloc* allocation, void** data) const
 {
 	allocation->mapped = true;
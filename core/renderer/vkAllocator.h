@@ -48,6 +48,12 @@ namespace vkAllocator {
 		void copyBufferToBufferCmd(VkCommandBuffer buffer, BufferAlloc* src, BufferAlloc* dst, VkDeviceSize size, bool freeOldBuffer = false) const;
 		void copyBufferToImageCmd(VkCommandBuffer buffer, BufferAlloc* src, ImageAlloc* dst, VkExtent3D extent, bool freeOldBuffer = false);
 		void transitionImageLayoutCmd(VkCommandBuffer cmdBuffer, ImageAlloc* image, VkImageLayout oldLayout, VkImageLayout newLayout);
+		// Raw memory for resources created outside of the allocator, such as aliased transient images.
+		void allocateMemory(Alloc* alloc, const VkMemoryRequirements& requirements, VkMemoryPropertyFlags requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) const;
+		void bindImageMemory(Alloc* alloc, VkImage image) const;
+		void freeMemory(Alloc* alloc) const;
+		// Makes host writes to non-coherent memory visible to the device, a no-op for coherent memory.
+		void flushAllocation(Alloc* allocation, VkDeviceSize offset, VkDeviceSize size) const;
 		void mapMemory(Alloc* allocation, void** data) const;
 		void unmapMemory(Alloc* allocation) const;
 
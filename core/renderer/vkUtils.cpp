@@ -1,2 +1,14 @@
 #include "core/globals.h"
 #include "vkUtils.h"
+
+uint64_t vkUtils::HashBytes(const void* data, size_t size, uint64_t seed)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
@@ -1,5 +1,56 @@
 #pragma once
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <cstring>
 
 namespace vkUtils {
+	constexpr uint64_t HASH_SEED = 14695981039346656037ull;
 
-}
\ No newline at end of file
+	// 64 bit FNV-1a, used to key caches of Vulkan objects on the state they were created from.
+	uint64_t HashBytes(const void* data, size_t size, uint64_t seed = HASH_SEED);
+
+	template <typename T>
+	uint64_t HashValue(const T& value, uint64_t seed = HASH_SEED) {
+		return HashBytes(&value, sizeof(T), seed);
+	}
+
+	inline uint64_t HashString(const std::string& str, uint64_t seed = HASH_SEED) {
+		return HashBytes(str.data(), str.size(), seed);
+	}
+
+	// The state a Vulkan object is created from, flattened to bytes along with their hash. Caches compare whole keys on
+	// lookup, so a hash collision can never return an object built from different state.
+	struct StateKey {
+		std::vector<uint8_t> bytes{};
+		uint64_t hash = HASH_SEED;
+
+		void AddBytes(const void* data, size_t size) {
+			const uint8_t* start = static_cast<const uint8_t*>(data);
+			bytes.insert(bytes.end(), start, start + size);
+			hash = HashBytes(data, size, hash);
+		}
+		template <typename T>
+		void Add(const T& value) {
+			AddBytes(&value, sizeof(T));
+		}
+		// Adds the element count followed by the elements, so adjacent arrays cannot be confused with each other.
+		template <typename T>
+		void AddArray(const T* data, size_t count) {
+			Add(count);
+			if (count > 0) AddBytes(data, count * sizeof(T));
+		}
+		void AddString(const char* str) {
+			AddArray(str, str != nullptr ? strlen(str) : 0);
+		}
+
+		friend bool operator==(const StateKey& lhs, const StateKey& rhs) {
+			return lhs.hash == rhs.hash && lhs.bytes == rhs.bytes;
+		}
+	};
+
+	struct StateKeyHash {
+		size_t operator()(const StateKey& key) const { return static_cast<size_t>(key.hash); }
+	};
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "string_name.h"
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+// Open addressing hash table from names to values, built once and then only read. Probing compares the precomputed
+// hashes, and a match is confirmed by comparing StringName pointers, so a lookup never compares characters.
+template <typename T>
+class NameTable {
+	private:
+	struct Entry {
+		StringName name{};
+		T value{};
+		bool used = false;
+	};
+
+	std::vector<Entry> _entries{};
+	size_t _mask = 0;
+	size_t _count = 0;
+
+	public:
+	// Replaces the contents of the table. If a name appears more than once the first occurrence is kept.
+	void Build(const std::vector<std::pair<StringName, T>>& items) {
+		size_t capacity = 8;
+		while (capacity < items.size() * 2) capacity <<= 1;
+		_entries.assign(capacity, Entry{});
+		_mask = capacity - 1;
+		_count = 0;
+
+		for (const std::pair<StringName, T>& item : items) {
+			size_t slot = item.first.Hash() & _mask;
+			while (_entries[slot].used && _entries[slot].name != item.first) {
+				slot = (slot + 1) & _mask;
+			}
+			if (_entries[slot].used) continue;
+			_entries[slot] = { item.first, item.second, true };
+			_count++;
+		}
+	}
+
+	// Returns the value stored for name, or a value initialised T if there is none.
+	T Find(const StringName& name) const {
+		if (_entries.empty()) return T{};
+		size_t slot = name.Hash() & _mask;
+		while (_entries[slot].used) {
+			if (_entries[slot].name == name) return _entries[slot].value;
+			slot = (slot + 1) & _mask;
+		}
+		return T{};
+	}
+
+	template <typename F>
+	void ForEach(F&& f) const {
+		for (const Entry& entry : _entries) {
+			if (entry.used) f(entry.name, entry.value);
+		}
+	}
+
+	size_t Size() const { return _count; }
+};
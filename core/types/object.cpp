@@ -2,25 +2,23 @@
 #include "type_registry.h"
 
 using namespace engine_type_registry;
-bool Object::_IsDerivedFrom(string className)
+bool Object::_IsDerivedFrom(const StringName& className)
 {
-	EngineClass* obj = type_registry::_registered_classes[this->_ClassName()]._inherits;
-	while (obj != nullptr) {
-		if (obj->_className == className) return true;
-		obj = obj->_inherits;
-	}
-	return false;
+	EngineClass* cls = type_registry::find_class(className);
+	if (cls == nullptr) return false;
+	uint32_t classId = _ClassId();
+	return classId != cls->_classId && type_registry::is_class_or_derived(classId, cls->_classId);
 }
 
 map<string, ObjectRTTIModel::ObjectMethodDefinition> Object::_GetMethodList()
 {
 	map<string, ObjectRTTIModel::ObjectMethodDefinition> methodList = {};
-	EngineClass* obj = &type_registry::_registered_classes[this->_ClassName()];
+	EngineClass* obj = type_registry::find_class(this->_ClassId());
 	while (obj != nullptr) {
-		std::map<string, ObjectRTTIModel::ObjectMethodDefinition>::iterator it= obj->_methods.begin();
+		std::map<string, ObjectMethod>::iterator it= obj->_methodBinds.begin();
 
-		while (it != obj->_methods.end()) {
-			methodList[it->first] = it->second;
+		while (it != obj->_methodBinds.end()) {
+			methodList[it->first] = it->second.methodMetadata;
 			it++;
 		}
 
@@ -30,43 +28,26 @@ map<string, ObjectRTTIModel::ObjectMethodDefinition> Object::_GetMethodList()
 	return methodList;
 }
 
-bool Object::_HasMethod(string methodName)
+bool Object::_HasMethod(const StringName& methodName)
 {
-	EngineClass* obj = &type_registry::_registered_classes[this->_ClassName()];
-	while (obj != nullptr) {
-		std::map<string, ObjectRTTIModel::ObjectMethodDefinition>::iterator it = obj->_methods.begin();
-
-		while (it != obj->_methods.end()) {
-			if (it->first == methodName) return true;
-			it++;
-		}
-
-		obj = obj->_inherits;
-	}
-	return false;
+	EngineClass* cls = type_registry::find_class(this->_ClassId());
+	return cls != nullptr && cls->FindMethod(methodName) != nullptr;
 }
 
-Variant Object::_callInternal(string methodName, vector<Variant> args)
+Variant Object::_callInternal(const StringName& methodName, std::span<const Variant> args)
 {
-	EngineClass* obj = &type_registry::_registered_classes[this->_ClassName()];
-	while (obj != nullptr) {
-		map<string, ObjectMethod*>::iterator it = obj->_methodBinds.begin();
-
-		while (it != obj->_methodBinds.end()) {
-			if (it->first == methodName) return it->second->Call(this, args);
-			it++;
-		}
-
-		obj = obj->_inherits;
-	}
-	return Variant(Variant::Void);
+	EngineClass* cls = type_registry::find_class(this->_ClassId());
+	if (cls == nullptr) return Variant(Variant::Void);
+	const ObjectMethod* method = cls->FindMethod(methodName);
+	if (method == nullptr) return Variant(Variant::Void);
+	return method->Call(this, args);
 }
 
 
 map<string, ObjectRTTIModel::ObjectPropertyDefinition> Object::_GetPropertyList()
 {
 	map<string, ObjectRTTIModel::ObjectPropertyDefinition> propertyList = {};
-	EngineClass* obj = &type_registry::_registered_classes[this->_ClassName()];
+	EngineClass* obj = type_registry::find_class(this->_ClassId());
 	while (obj != nullptr) {
 		std::map<string, ObjectRTTIModel::ObjectPropertyDefinition>::iterator it = obj->_properties.begin();
 
@@ -81,64 +62,25 @@ map<string, ObjectRTTIModel::ObjectPropertyDefinition> Object::_GetPropertyList(
 	return propertyList;
 }
 
-bool Object::_HasProperty(string propertyName)
+bool Object::_HasProperty(const StringName& propertyName)
 {
-	EngineClass* obj = &type_registry::_registered_classes[this->_ClassName()];
-	while (obj != nullptr) {
-		std::map<string, ObjectRTTIModel::ObjectPropertyDefinition>::iterator it = obj->_properties.begin();
-
-		while (it != obj->_properties.end()) {
-			if (it->first == propertyName) return true;
-			it++;
-		}
-
-		obj = obj->_inherits;
-	}
-
-	return false;
+	EngineClass* cls = type_registry::find_class(this->_ClassId());
+	return cls != nullptr && cls->FindProperty(propertyName) != nullptr;
 }
 
-void Object::_Set(string propertyName, Variant value)
+void Object::_Set(const StringName& propertyName, const Variant& value)
 {
-	EngineClass* obj = &type_registry::_registered_classes[this->_ClassName()];
-	ObjectRTTIModel::ObjectPropertyDefinition prop;
-	while (obj != nullptr) {
-		std::map<string, ObjectRTTIModel::ObjectPropertyDefinition>::iterator it = obj->_properties.begin();
-
-		while (it != obj->_properties.end()) {
-			if (it->first == propertyName) {
-				prop = it->second;
-				break;
-			}
-			it++;
-		}
-
-		obj = obj->_inherits;
-	}
-
-	if (prop.flags & ObjectRTTIModel::ObjectPropertyDefinition::READ_ONLY) {
-		return;
-	}
-	this->_Call(prop.setterName, value);
+	EngineClass* cls = type_registry::find_class(this->_ClassId());
+	if (cls == nullptr) return;
+	PropertyHandle prop = cls->ResolveProperty(propertyName);
+	if (prop.IsValid()) prop.Set(this, value);
 }
 
-Variant Object::_Get(string propertyName)
+Variant Object::_Get(const StringName& propertyName)
 {
-	EngineClass* obj = &type_registry::_registered_classes[this->_ClassName()];
-	ObjectRTTIModel::ObjectPropertyDefinition prop;
-	while (obj != nullptr) {
-		std::map<string, ObjectRTTIModel::ObjectPropertyDefinition>::iterator it = obj->_properties.begin();
-
-		while (it != obj->_properties.end()) {
-			if (it->first == propertyName) {
-				prop = it->second;
-				break;
-			}
-			it++;
-		}
-
-		obj = obj->_inherits;
-	}
-
-	return this->_Call(prop.getterName);
+	EngineClass* cls = type_registry::find_class(this->_ClassId());
+	if (cls == nullptr) return Variant(Variant::Void);
+	PropertyHandle prop = cls->ResolveProperty(propertyName);
+	if (!prop.IsValid()) return Variant(Variant::Void);
+	return prop.Get(this);
 }
@@ -1,7 +1,9 @@
 #pragma once
 #include "variant_type.h"
+#include "string_name.h"
 #include <vector>
 #include <map>
+#include <span>
 // Base class for everything, provides RTTI and engine boilerplate.
 
 namespace ObjectRTTIModel {
@@ -21,10 +23,10 @@ namespace ObjectRTTIModel {
 		string propertyName = "";
 		int32_t flags = 0;
 		Variant::StoredType type = Variant::StoredType::Void;
-		string getterName = "";
-		string setterName = "";
+		StringName getterName{};
+		StringName setterName{};
 		ObjectPropertyDefinition() {}
-		ObjectPropertyDefinition(string propName, Variant::StoredType ty, PropertyFlags pflags, string getter, string setter = "") {
+		ObjectPropertyDefinition(string propName, Variant::StoredType ty, PropertyFlags pflags, StringName getter, StringName setter = StringName()) {
 			propertyName = propName;
 			type = ty;
 			flags = pflags;
@@ -50,26 +52,30 @@ namespace ObjectRTTIModel {
 
 class Object {
 	private:
-	Variant _callInternal(string methodName, vector<Variant> args);
+	Variant _callInternal(const StringName& methodName, std::span<const Variant> args);
 	protected:
 
 	public:
-	virtual string _ClassName() { return "Object"; };
-	virtual string _DerivedFrom() { return ""; };
-	bool _IsDerivedFrom(string className);
+	virtual const StringName& _ClassName() { static const StringName name("Object"); return name; };
+	virtual const StringName& _DerivedFrom() { static const StringName name{}; return name; };
+	// The id of the object's class, see engine_type_registry::EngineClass. UINT32_MAX until classes are registered.
+	virtual uint32_t _ClassId() { return UINT32_MAX; }
+	bool _IsDerivedFrom(const StringName& className);
 
 	map<string, ObjectRTTIModel::ObjectMethodDefinition> _GetMethodList();
-	bool _HasMethod(string methodName);
+	bool _HasMethod(const StringName& methodName);
+	// Arguments are held in a fixed size array on the stack and passed down by reference, so calls with few arguments
+	// do not allocate.
 	template <typename... Args>
-	Variant _Call(string methodName, Args... args) {
-		std::vector<Variant> argVector { Variant(args)... };
-		return _callInternal(methodName, argVector);
+	Variant _Call(const StringName& methodName, Args&&... args) {
+		const Variant argArray[sizeof...(Args) == 0 ? 1 : sizeof...(Args)] { Variant(std::forward<Args>(args))... };
+		return _callInternal(methodName, std::span<const Variant>(argArray, sizeof...(Args)));
 	};
 
 	map<string, ObjectRTTIModel::ObjectPropertyDefinition> _GetPropertyList();
-	bool _HasProperty(string propertyName);
-	void _Set(string property, Variant value);
-	Variant _Get(string property);
+	bool _HasProperty(const StringName& propertyName);
+	void _Set(const StringName& property, const Variant& value);
+	Variant _Get(const StringName& property);
 
 	virtual void _Init() {}
 	virtual ~Object() {}
@@ -0,0 +1,63 @@
+#include "object_pool.h"
+#include <new>
+#include <algorithm>
+#include <cstdint>
+
+// Slabs are sized to hold roughly this many bytes of objects, and never fewer than MIN_SLOTS_PER_SLAB objects.
+constexpr size_t SLAB_BYTES = 16 * 1024;
+constexpr size_t MIN_SLOTS_PER_SLAB = 8;
+
+ObjectPool::ObjectPool(size_t objectSize, size_t alignment)
+{
+	_objectSize = objectSize;
+	_alignment = std::max(alignment, alignof(FreeSlot));
+	size_t size = std::max(objectSize, sizeof(FreeSlot));
+	_slotSize = (size + _alignment - 1) / _alignment * _alignment;
+	_slotsPerSlab = std::max(MIN_SLOTS_PER_SLAB, SLAB_BYTES / _slotSize);
+}
+
+void ObjectPool::_addSlab()
+{
+	uint8_t* slab = static_cast<uint8_t*>(::operator new(_slotSize * _slotsPerSlab, std::align_val_t(_alignment)));
+	_slabs.push_back(slab);
+	// Slots are pushed in reverse so they are handed out in address order.
+	for (size_t i = _slotsPerSlab; i > 0; i--) {
+		FreeSlot* slot = reinterpret_cast<FreeSlot*>(slab + (i - 1) * _slotSize);
+		slot->next = _freeList;
+		_freeList = slot;
+	}
+}
+
+void* ObjectPool::Allocate(size_t size)
+{
+	if (size != _objectSize) return ::operator new(size);
+
+	std::lock_guard lock(_mutex);
+	if (_freeList == nullptr) _addSlab();
+	FreeSlot* slot = _freeList;
+	_freeList = slot->next;
+	_liveCount++;
+	return slot;
+}
+
+void ObjectPool::Free(void* ptr, size_t size)
+{
+	if (ptr == nullptr) return;
+	if (size != _objectSize) {
+		::operator delete(ptr);
+		return;
+	}
+
+	std::lock_guard lock(_mutex);
+	FreeSlot* slot = static_cast<FreeSlot*>(ptr);
+	slot->next = _freeList;
+	_freeList = slot;
+	_liveCount--;
+}
+
+ObjectPool::~ObjectPool()
+{
+	for (void* slab : _slabs) {
+		::operator delete(slab, std::align_val_t(_alignment));
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <vector>
+#include <mutex>
+#include <cstddef>
+
+// Fixed size allocator for the objects of one class. Memory is taken from the system in slabs holding many objects, so
+// objects of the same class sit close together, and freed objects are kept on a free list for later allocations.
+// Requests of any other size, such as from a derived class that does not declare its own pool, are passed on to the
+// global allocator.
+class ObjectPool {
+	private:
+	struct FreeSlot {
+		FreeSlot* next;
+	};
+
+	size_t _objectSize;
+	size_t _slotSize;
+	size_t _alignment;
+	size_t _slotsPerSlab;
+	FreeSlot* _freeList = nullptr;
+	std::vector<void*> _slabs{};
+	size_t _liveCount = 0;
+	std::mutex _mutex{};
+
+	void _addSlab();
+
+	public:
+	ObjectPool(size_t objectSize, size_t alignment);
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool& operator=(const ObjectPool&) = delete;
+
+	void* Allocate(size_t size);
+	void Free(void* ptr, size_t size);
+
+	size_t GetObjectSize() const { return _objectSize; }
+	size_t GetLiveCount() const { return _liveCount; }
+	size_t GetSlabCount() const { return _slabs.size(); }
+
+	~ObjectPool();
+};
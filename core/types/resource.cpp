@@ -12,13 +12,9 @@ void Resource::_register_type()
 	type_registry::class_expose_method(ObjectMethodDefinition("SetPath", Variant::StoredType::Void, 1), &Resource::SetPath);
 	type_registry::class_expose_method(ObjectMethodDefinition("IsSaved", Variant::StoredType::Bool, 0), &Resource::IsSaved);
 
-	ObjectRTTIModel::ObjectPropertyDefinition nameProp = ObjectPropertyDefinition("Name", Variant::StoredType::String, ObjectPropertyDefinition::NONE, "Name", "SetName");
-	ObjectRTTIModel::ObjectPropertyDefinition pathProp = ObjectPropertyDefinition("Path", Variant::StoredType::String, ObjectPropertyDefinition::NONE, "GetPath", "SetPath");
-	ObjectRTTIModel::ObjectPropertyDefinition savedProp = ObjectPropertyDefinition("Saved", Variant::StoredType::String, ObjectPropertyDefinition::READ_ONLY, "IsSaved");
-
-	type_registry::class_define_property(nameProp);
-	type_registry::class_define_property(pathProp);
-	type_registry::class_define_property(savedProp);
+	type_registry::class_define_member_property("Name", ObjectPropertyDefinition::NONE, &Resource::_name);
+	type_registry::class_define_member_property("Path", ObjectPropertyDefinition::NONE, &Resource::_resourcePath);
+	type_registry::class_define_member_property("Saved", ObjectPropertyDefinition::READ_ONLY, &Resource::_saved);
 	
 	type_registry::end_class();
 
@@ -0,0 +1,42 @@
+#include "string_name.h"
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+
+// Entries are never freed, so views of their text and pointers to them stay valid for the life of the program. The
+// table itself is never destroyed either, so names can still be used by other statics during shutdown.
+static std::unordered_map<std::string_view, StringName::Entry*>& intern_table() {
+	static std::unordered_map<std::string_view, StringName::Entry*>* table = new std::unordered_map<std::string_view, StringName::Entry*>();
+	return *table;
+}
+
+static std::shared_mutex& intern_mutex() {
+	static std::shared_mutex* mutex = new std::shared_mutex();
+	return *mutex;
+}
+
+const StringName::Entry* StringName::intern(std::string_view name)
+{
+	// The empty name is represented by a null entry.
+	if (name.empty()) return nullptr;
+
+	std::unordered_map<std::string_view, Entry*>& table = intern_table();
+	{
+		std::shared_lock lock(intern_mutex());
+		std::unordered_map<std::string_view, Entry*>::iterator it = table.find(name);
+		if (it != table.end()) return it->second;
+	}
+
+	std::unique_lock lock(intern_mutex());
+	std::unordered_map<std::string_view, Entry*>::iterator it = table.find(name);
+	if (it != table.end()) return it->second;
+	Entry* entry = new Entry{ std::string(name), hash_name(name) };
+	table.emplace(std::string_view(entry->name), entry);
+	return entry;
+}
+
+const std::string& StringName::String() const
+{
+	static const std::string empty{};
+	return _entry ? _entry->name : empty;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <functional>
+#include <cstdint>
+
+// 64 bit FNV-1a hash, used to key RTTI lookups by name.
+constexpr uint64_t hash_name(std::string_view name) {
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : name) {
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+// An interned, immutable name used for class, method and property identifiers. Every StringName with the same text
+// points at the same entry of a global table, so copies are a pointer copy and comparing or hashing two names never
+// touches the characters. Constructing a StringName from text looks it up in the table, so names used repeatedly
+// should be constructed once and kept, e.g. in a static.
+class StringName {
+	public:
+	struct Entry {
+		std::string name;
+		uint64_t hash;
+	};
+
+	private:
+	const Entry* _entry = nullptr;
+
+	static const Entry* intern(std::string_view name);
+
+	public:
+	StringName() {}
+	StringName(std::string_view name) : _entry(intern(name)) {}
+	StringName(const char* name) : _entry(intern(name)) {}
+	StringName(const std::string& name) : _entry(intern(name)) {}
+
+	const std::string& String() const;
+	std::string_view View() const { return _entry ? std::string_view(_entry->name) : std::string_view(); }
+	uint64_t Hash() const { return _entry ? _entry->hash : hash_name({}); }
+	bool IsEmpty() const { return _entry == nullptr; }
+
+	operator const std::string&() const { return String(); }
+
+	friend bool operator==(const StringName& lhs, const StringName& rhs) { return lhs._entry == rhs._entry; }
+};
+
+template <>
+struct std::hash<StringName> {
+	size_t operator()(const StringName& name) const noexcept {
+		return static_cast<size_t>(name.Hash());
+	}
+};
@@ -8,39 +8,128 @@
 #include "project/resources/image.h"
 
 using namespace engine_type_registry;
-map<string, EngineClass> type_registry::_registered_classes{};
-string type_registry::_currentClass = "";
+unordered_map<StringName, EngineClass> type_registry::_registered_classes{};
+StringName type_registry::_currentClass{};
+EngineClass* type_registry::_currentClassRecord = nullptr;
+vector<EngineClass*> type_registry::_classesById{};
 void type_registry::register_all_types()
 {
 	using namespace resources;
 	register_class<Resource>();
 	register_class<Shader>();
 	register_class<Image>();
+	build_lookup_tables();
 }
 
-void type_registry::register_new_class(string new_class_name, string parent_class_name)
+void type_registry::build_lookup_tables()
+{
+	_assignClassIds();
+	for (std::pair<const StringName, EngineClass>& cls : _registered_classes) {
+		cls.second._buildLookupTables();
+	}
+}
+
+void type_registry::_assignClassIds()
+{
+	// Classes are visited in name order, so ids do not depend on the order of the hash map.
+	map<string, EngineClass*> sortedClasses{};
+	for (std::pair<const StringName, EngineClass>& cls : _registered_classes) {
+		sortedClasses.emplace(cls.first.String(), &cls.second);
+	}
+	unordered_map<const EngineClass*, vector<EngineClass*>> children{};
+	vector<EngineClass*> roots{};
+	for (const std::pair<const string, EngineClass*>& cls : sortedClasses) {
+		if (cls.second->_inherits != nullptr) children[cls.second->_inherits].push_back(cls.second);
+		else roots.push_back(cls.second);
+	}
+
+	_classesById.clear();
+	_classesById.reserve(sortedClasses.size());
+	std::function<void(EngineClass*)> visit = [&](EngineClass* cls) {
+		cls->_classId = static_cast<uint32_t>(_classesById.size());
+		_classesById.push_back(cls);
+		for (EngineClass* child : children[cls]) {
+			visit(child);
+		}
+		cls->_lastDescendantId = static_cast<uint32_t>(_classesById.size() - 1);
+		if (cls->_classIdSlot != nullptr) *cls->_classIdSlot = cls->_classId;
+	};
+	for (EngineClass* root : roots) {
+		visit(root);
+	}
+}
+
+bool PropertyHandle::_allInstances(std::span<Object* const> objects) const
+{
+	for (Object* obj : objects) {
+		if (obj == nullptr || !type_registry::is_class_or_derived(obj->_ClassId(), _classId)) return false;
+	}
+	return true;
+}
+
+void EngineClass::_buildLookupTables()
+{
+	std::vector<std::pair<StringName, const ObjectMethod*>> methods{};
+	// Walking from this class up means derived definitions come first, and NameTable keeps the first of a name.
+	for (EngineClass* cls = this; cls != nullptr; cls = cls->_inherits) {
+		for (const std::pair<const string, ObjectMethod>& method : cls->_methodBinds) {
+			methods.push_back({ method.first, &method.second });
+		}
+	}
+	_allMethods.Build(methods);
+
+	// Property handles are resolved against the finished method table.
+	map<string, PropertyHandle> sortedProperties{};
+	for (EngineClass* cls = this; cls != nullptr; cls = cls->_inherits) {
+		for (const std::pair<const string, ObjectRTTIModel::ObjectPropertyDefinition>& property : cls->_properties) {
+			if (sortedProperties.contains(property.first)) continue;
+			map<string, ObjectMember>::const_iterator member = cls->_memberBinds.find(property.first);
+			if (member != cls->_memberBinds.end()) {
+				sortedProperties.emplace(property.first, PropertyHandle(&property.second, &member->second));
+			}
+			else {
+				sortedProperties.emplace(property.first, PropertyHandle(&property.second, ResolveMethod(property.second.getterName), ResolveMethod(property.second.setterName)));
+			}
+		}
+	}
+	_propertyHandles.clear();
+	_propertyHandles.reserve(sortedProperties.size());
+	for (const std::pair<const string, PropertyHandle>& property : sortedProperties) {
+		_propertyHandles.push_back(property.second);
+		_propertyHandles.back()._classId = _classId;
+	}
+
+	std::vector<std::pair<StringName, const PropertyHandle*>> properties{};
+	for (const PropertyHandle& handle : _propertyHandles) {
+		properties.push_back({ handle.GetDefinition().propertyName, &handle });
+	}
+	_allProperties.Build(properties);
+}
+
+void type_registry::register_new_class(const StringName& new_class_name, const StringName& parent_class_name)
 {
 	if (_registered_classes.contains(new_class_name)) {
-		Log.Error("TypeRegistry", "Attempted to register class with name '" + new_class_name + "' twice.");
+		Log.Error("TypeRegistry", "Attempted to register class with name '" + new_class_name.String() + "' twice.");
 		return;
 	}
 	EngineClass newClass{};
 	newClass._className = new_class_name;
 	newClass._parentClassName = parent_class_name;
-	if (newClass._parentClassName != "" && newClass._parentClassName != "Object") {
+	if (!newClass._parentClassName.IsEmpty() && newClass._parentClassName != StringName("Object")) {
 		newClass._inherits = &_registered_classes[newClass._parentClassName];
 	}
 	_registered_classes[new_class_name] = newClass;
 
 	_currentClass = new_class_name;
+	_currentClassRecord = &_registered_classes[new_class_name];
 
 }
 
 void engine_type_registry::type_registry::class_define_property(ObjectRTTIModel::ObjectPropertyDefinition def) {
-	if (_registered_classes[_currentClass]._properties.contains(def.propertyName)) {
-		Log.Warn("TypeRegistry", "Attempted to redefine property " + _currentClass + "::" + def.propertyName);
+	if (_currentClassRecord->_properties.contains(def.propertyName)) {
+		Log.Warn("TypeRegistry", "Attempted to redefine property " + _currentClass.String() + "::" + def.propertyName);
 		return;
 	}
-	_registered_classes[_currentClass]._properties[def.propertyName] = def;
+	_currentClassRecord->_properties[def.propertyName] = def;
 }
 
@@ -2,6 +2,7 @@
 #include "core/globals.h"
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <functional>
 #include <concepts>
@@ -10,8 +11,12 @@
 #include <array>
 #include <algorithm>
 #include <iterator>
+#include <span>
+#include <cstring>
 #include "object.h"
 #include "variant_type.h"
+#include "name_table.h"
+#include "object_pool.h"
 
 using namespace std;
 
@@ -20,120 +25,317 @@ using namespace std;
 friend class engine_type_registry::type_registry; \
 static void _register_type(); \
 public: \
-static string _ClassNameStatic() {return #NAME;} \
-static string _DerivedFromStatic() {return #DERIVED;} \
-string _ClassName() override {return #NAME; } \
-string _DerivedFrom() override {return #DERIVED; } \
+static const StringName& _ClassNameStatic() {static const StringName name(#NAME); return name;} \
+static const StringName& _DerivedFromStatic() {static const StringName name(#DERIVED); return name;} \
+const StringName& _ClassName() override {return _ClassNameStatic(); } \
+const StringName& _DerivedFrom() override {return _DerivedFromStatic(); } \
+static uint32_t& _ClassIdStatic() {static uint32_t id = UINT32_MAX; return id;} \
+uint32_t _ClassId() override {return _ClassIdStatic(); } \
+static ObjectPool& _PoolStatic() {static ObjectPool* pool = new ObjectPool(sizeof(NAME), alignof(NAME)); return *pool;} \
+static void* operator new(size_t size) {return _PoolStatic().Allocate(size);} \
+static void operator delete(void* ptr, size_t size) {_PoolStatic().Free(ptr, size);} \
 private: \
 
 template <class Type>
 concept IsDerivedFromObject = std::is_base_of<Object, Type>::value;
 
+// Objects of classes declared with GUS_DECLARE_CLASS are allocated from their class's ObjectPool, so deleting the
+// returned object returns it to the pool.
 template <typename T>
 static Object* dynamic_constructor() {
 	Object* ret = new T;
 	return ret;
 }
 
+template <typename T>
+struct is_const_span : std::false_type {};
+template <typename E>
+struct is_const_span<std::span<const E>> : std::true_type {};
+
+// Converts a call argument to the parameter type of a bound method. Parameters declared as const Variant&, string_view,
+// or a span of const elements refer to the argument's data directly. Anything else is converted to a value.
+template <typename A>
+static decltype(auto) variant_to_arg(const Variant& v) {
+	using T = std::remove_cvref_t<A>;
+	if constexpr (std::is_same_v<T, Variant>) {
+		return (v);
+	}
+	else if constexpr (std::is_same_v<T, std::string_view>) {
+		return v.GetStringView();
+	}
+	else if constexpr (is_const_span<T>::value) {
+		using E = std::remove_const_t<typename T::element_type>;
+		if constexpr (std::is_same_v<E, Variant>) return v.GetVariantArrayView();
+		else return v.GetPackedArrayView<E>();
+	}
+	else {
+		return static_cast<T>(v);
+	}
+}
+
+// Points resolved at the passed argument for each parameter, or at its default value if it was not passed. Parameters
+// after the first requiredArgCount take their defaults from defaultArgs in order. Returns false if an argument is missing.
+static bool resolve_call_args(std::span<const Variant> args, size_t paramCount, int32_t requiredArgCount, const vector<Variant>& defaultArgs, const Variant* resolved[]) {
+	if (args.size() < static_cast<size_t>(requiredArgCount)) return false;
+	for (size_t i = 0; i < paramCount; i++) {
+		if (i < args.size()) {
+			resolved[i] = &args[i];
+		}
+		else if (i >= static_cast<size_t>(requiredArgCount) && i - requiredArgCount < defaultArgs.size()) {
+			resolved[i] = &defaultArgs[i - requiredArgCount];
+		}
+		else {
+			return false;
+		}
+	}
+	return true;
+}
+
 template <typename R, typename T, typename... Args, std::size_t... Is> requires IsDerivedFromObject<T>
-static Variant call_class_method_helper_impl(T* obj, R(T::* method)(Args...), const Variant resolvedArgs[], std::index_sequence<Is...>) {
+static Variant call_class_method_helper_impl(T* obj, R(T::* method)(Args...), const Variant* const resolvedArgs[], std::index_sequence<Is...>) {
 	if constexpr (std::is_void_v<R>) {		
-		(obj->*method)(static_cast<Args>(resolvedArgs[Is])...);
+		(obj->*method)(variant_to_arg<Args>(*resolvedArgs[Is])...);
 		return Variant(Variant::Void);
 	}
 	else {
-		return (obj->*method)(static_cast<Args>(resolvedArgs[Is])...);
+		return (obj->*method)(variant_to_arg<Args>(*resolvedArgs[Is])...);
 	}
 }
 
 template <typename R, typename T, typename... Args, std::size_t... Is> requires IsDerivedFromObject<T>
-static Variant call_class_method_helper_impl(T* obj, R(T::* method)(Args...)const, const Variant resolvedArgs[], std::index_sequence<Is...>) {
+static Variant call_class_method_helper_impl(T* obj, R(T::* method)(Args...)const, const Variant* const resolvedArgs[], std::index_sequence<Is...>) {
 	if constexpr (std::is_void_v<R>) {
-		(obj->*method)(static_cast<Args>(resolvedArgs[Is])...);
+		(obj->*method)(variant_to_arg<Args>(*resolvedArgs[Is])...);
 		return Variant(Variant::Void);
 	}
 	else {
-		return (obj->*method)(static_cast<Args>(resolvedArgs[Is])...);
+		return (obj->*method)(variant_to_arg<Args>(*resolvedArgs[Is])...);
 	}
 }
 
+// Arguments are passed as a span and resolved to pointers on the stack, so a call never copies or allocates for them.
 template <typename R, typename T, typename... Args> requires IsDerivedFromObject<T>
-static Variant call_class_method_helper(T* obj, R(T::* method)(Args...), const vector<Variant> args, int32_t requiredArgCount, const vector<Variant>& defaultArgs, bool& callSuccessfull) {
-	if (args.size() < requiredArgCount) {
-		callSuccessfull = false;
-		return Variant(Variant::Void);
-	}
-
-	Variant resolvedArgs[sizeof...(Args) == 0 ? 1 : sizeof...(Args)]{};
-	for (int32_t i = 0; i < (int32_t)sizeof...(Args); i++) {
-		if (i >= args.size()-1) {
-			resolvedArgs[i] = args[i];
-		}
-		else {
-			resolvedArgs[i] = defaultArgs[i];
-		}
-	}
+static Variant call_class_method_helper(T* obj, R(T::* method)(Args...), std::span<const Variant> args, int32_t requiredArgCount, const vector<Variant>& defaultArgs, bool& callSuccessfull) {
+	const Variant* resolvedArgs[sizeof...(Args) == 0 ? 1 : sizeof...(Args)]{};
+	callSuccessfull = resolve_call_args(args, sizeof...(Args), requiredArgCount, defaultArgs, resolvedArgs);
+	if (!callSuccessfull) return Variant(Variant::Void);
 
 	return call_class_method_helper_impl(obj, method, resolvedArgs, std::index_sequence_for<Args...>());
 }
 
 template <typename R, typename T, typename... Args> requires IsDerivedFromObject<T>
-static Variant call_class_method_helper(T* obj, R(T::* method)(Args...) const, const vector<Variant> args, int32_t requiredArgCount, const vector<Variant>& defaultArgs, bool& callSuccessfull) {
-	if (args.size() < requiredArgCount) {
-		callSuccessfull = false;
-		return Variant(Variant::Void);
-	}
-
-	Variant resolvedArgs[sizeof...(Args) == 0 ? 1 : sizeof...(Args)]{};
-	for (int32_t i = 0; i < (int32_t)sizeof...(Args); i++) {
-		if (i >= args.size() - 1) {
-			resolvedArgs[i] = args[i];
-		}
-		else {
-			resolvedArgs[i] = defaultArgs[i];
-		}
-	}
+static Variant call_class_method_helper(T* obj, R(T::* method)(Args...) const, std::span<const Variant> args, int32_t requiredArgCount, const vector<Variant>& defaultArgs, bool& callSuccessfull) {
+	const Variant* resolvedArgs[sizeof...(Args) == 0 ? 1 : sizeof...(Args)]{};
+	callSuccessfull = resolve_call_args(args, sizeof...(Args), requiredArgCount, defaultArgs, resolvedArgs);
+	if (!callSuccessfull) return Variant(Variant::Void);
 
 	return call_class_method_helper_impl(obj, method, resolvedArgs, std::index_sequence_for<Args...>());
 }
 
 namespace engine_type_registry {
+	// Type erased copy of a pointer to member. Member function pointers can be several words long, so they are held in
+	// a fixed buffer large enough for any of them rather than allocated.
+	struct MemberPointerStorage {
+		alignas(void*) unsigned char bytes[4 * sizeof(void*)]{};
+
+		template <typename P>
+		static MemberPointerStorage From(P pointer) {
+			static_assert(sizeof(P) <= sizeof(bytes), "Pointer to member is too large");
+			MemberPointerStorage storage{};
+			memcpy(storage.bytes, &pointer, sizeof(P));
+			return storage;
+		}
+		template <typename P>
+		P As() const {
+			P pointer;
+			memcpy(&pointer, bytes, sizeof(P));
+			return pointer;
+		}
+	};
+
+	// A method bound to a class. It is stored by value in its class, and calls go through a function instantiated for
+	// the method's signature, so binding a method allocates nothing and needs no virtual dispatch.
 	class ObjectMethod {
 		public:
 		ObjectRTTIModel::ObjectMethodDefinition methodMetadata;
-		ObjectMethod(ObjectRTTIModel::ObjectMethodDefinition methodInfo) {
-			methodMetadata = methodInfo;
+
+		private:
+		Variant (*_invoke)(const ObjectMethod& method, Object* obj, std::span<const Variant> args) = nullptr;
+		MemberPointerStorage _function{};
+
+		template <typename R, typename T, typename... Args>
+		static Variant _invokeMethod(const ObjectMethod& method, Object* obj, std::span<const Variant> args) {
+			bool success = false;
+			return call_class_method_helper<R, T, Args...>(static_cast<T*>(obj), method._function.As<R(T::*)(Args...)>(), args,
+				method.methodMetadata.requiredArgCount, method.methodMetadata.defaultArgValues, success);
+		}
+		template <typename R, typename T, typename... Args>
+		static Variant _invokeConstMethod(const ObjectMethod& method, Object* obj, std::span<const Variant> args) {
+			bool success = false;
+			return call_class_method_helper<R, T, Args...>(static_cast<T*>(obj), method._function.As<R(T::*)(Args...) const>(), args,
+				method.methodMetadata.requiredArgCount, method.methodMetadata.defaultArgValues, success);
+		}
+
+		public:
+		ObjectMethod() {}
+		template <typename R, typename T, typename... Args> requires IsDerivedFromObject<T>
+		ObjectMethod(R(T::* met)(Args...), ObjectRTTIModel::ObjectMethodDefinition methodInfo)
+			: methodMetadata(std::move(methodInfo)), _invoke(&_invokeMethod<R, T, Args...>), _function(MemberPointerStorage::From(met)) {}
+		template <typename R, typename T, typename... Args> requires IsDerivedFromObject<T>
+		ObjectMethod(R(T::* met)(Args...) const, ObjectRTTIModel::ObjectMethodDefinition methodInfo)
+			: methodMetadata(std::move(methodInfo)), _invoke(&_invokeConstMethod<R, T, Args...>), _function(MemberPointerStorage::From(met)) {}
+
+		Variant Call(Object* obj, std::span<const Variant> args) const {
+			return _invoke(*this, obj, args);
 		}
+	};
 
-		virtual Variant Call(Object* obj, std::vector<Variant> args) const = 0;
+	class ObjectMember;
+	// Typed access functions for one member type of one class, shared by every member of that type.
+	struct ObjectMemberAccessors {
+		Variant (*load)(const ObjectMember& member, const Object* obj);
+		void (*store)(const ObjectMember& member, Object* obj, const Variant& value);
+		void* (*address)(const ObjectMember& member, Object* obj);
 	};
 
-	template <typename R, typename T, typename... Args> requires IsDerivedFromObject<T>
-	class BindedObjectMethod : public ObjectMethod {
+	// A data member exposed as a property, see type_registry::class_define_member_property. Reading and writing it is a
+	// typed load or store through a member pointer, with no method call.
+	class ObjectMember {
+		public:
+		Variant::StoredType type = Variant::Empty;
+		size_t size = 0;
+		// Set when the member holds a numeric type in exactly the bytes the Variant would, so it can be copied to and
+		// from serialised data directly.
+		bool isNumeric = false;
+
 		private:
-		bool _isConst;
+		const ObjectMemberAccessors* _accessors = nullptr;
+		MemberPointerStorage _member{};
+
+		template <typename T, typename M>
+		static Variant _load(const ObjectMember& member, const Object* obj) {
+			return Variant(static_cast<const T*>(obj)->*member._member.As<M T::*>());
+		}
+		template <typename T, typename M>
+		static void _store(const ObjectMember& member, Object* obj, const Variant& value) {
+			static_cast<T*>(obj)->*member._member.As<M T::*>() = static_cast<M>(value);
+		}
+		template <typename T, typename M>
+		static void* _address(const ObjectMember& member, Object* obj) {
+			return &(static_cast<T*>(obj)->*member._member.As<M T::*>());
+		}
+		template <typename T, typename M>
+		static constexpr ObjectMemberAccessors _accessorsFor{ &_load<T, M>, &_store<T, M>, &_address<T, M> };
 
 		public:
-		R(T::* constMethod)(Args...) const = nullptr;
-		R(T::* method)(Args...) = nullptr;
-		
-		virtual Variant Call(Object* obj, std::vector<Variant> args) const override {
-			bool success = false;
-			if (_isConst) {
-				return call_class_method_helper<R, T, Args...>(static_cast<T*>(obj), constMethod, args, methodMetadata.requiredArgCount, methodMetadata.defaultArgValues, success);
+		ObjectMember() {}
+		template <typename T, typename M> requires IsDerivedFromObject<T>
+		ObjectMember(M T::* member) : type(Variant::TypeOf<M>()), size(sizeof(M)),
+			isNumeric(std::is_trivially_copyable_v<M> && Variant::NumericSize(Variant::TypeOf<M>()) == sizeof(M)),
+			_accessors(&_accessorsFor<T, M>), _member(MemberPointerStorage::From(member)) {}
+
+		Variant Load(const Object* obj) const { return _accessors->load(*this, obj); }
+		void Store(Object* obj, const Variant& value) const { _accessors->store(*this, obj, value); }
+		void* Address(Object* obj) const { return _accessors->address(*this, obj); }
+	};
+
+	// A method resolved once for a class, which can then be called on any number of objects of that class, or of a class
+	// derived from it, without looking it up again. Calling it on an object of an unrelated class is undefined.
+	class MethodHandle {
+		private:
+		const ObjectMethod* _method = nullptr;
+
+		public:
+		MethodHandle() {}
+		MethodHandle(const ObjectMethod* method) : _method(method) {}
+
+		bool IsValid() const { return _method != nullptr; }
+		const ObjectRTTIModel::ObjectMethodDefinition& GetDefinition() const { return _method->methodMetadata; }
+
+		template <typename... Args>
+		Variant Call(Object* obj, Args&&... args) const {
+			const Variant argArray[sizeof...(Args) == 0 ? 1 : sizeof...(Args)] { Variant(std::forward<Args>(args))... };
+			return CallWithArgs(obj, std::span<const Variant>(argArray, sizeof...(Args)));
+		}
+
+		Variant CallWithArgs(Object* obj, std::span<const Variant> args) const {
+			if (_method == nullptr) return Variant(Variant::Void);
+			return _method->Call(obj, args);
+		}
+	};
+
+	// A property resolved once for a class, along with its getter and setter or its data member, see MethodHandle.
+	class PropertyHandle {
+		friend class EngineClass;
+		private:
+		const ObjectRTTIModel::ObjectPropertyDefinition* _property = nullptr;
+		MethodHandle _getter{};
+		MethodHandle _setter{};
+		const ObjectMember* _member = nullptr;
+		// The id of the class the handle was resolved for, which every object passed to Export or Import must be.
+		uint32_t _classId = UINT32_MAX;
+
+		// Whether every object is non-null and of the handle's class or a class derived from it.
+		bool _allInstances(std::span<Object* const> objects) const;
+
+		public:
+		PropertyHandle() {}
+		PropertyHandle(const ObjectRTTIModel::ObjectPropertyDefinition* property, MethodHandle getter, MethodHandle setter) : _property(property), _getter(getter), _setter(setter) {}
+		PropertyHandle(const ObjectRTTIModel::ObjectPropertyDefinition* property, const ObjectMember* member) : _property(property), _member(member) {}
+
+		bool IsValid() const { return _property != nullptr; }
+		bool IsReadOnly() const { return (_property->flags & ObjectRTTIModel::ObjectPropertyDefinition::READ_ONLY) || (_member == nullptr && !_setter.IsValid()); }
+		const ObjectRTTIModel::ObjectPropertyDefinition& GetDefinition() const { return *_property; }
+		// The data member backing the property, or nullptr if it is accessed through methods.
+		const ObjectMember* GetMember() const { return _member; }
+
+		Variant Get(Object* obj) const {
+			if (_member != nullptr) return _member->Load(obj);
+			return _getter.Call(obj);
+		}
+
+		void Set(Object* obj, const Variant& value) const {
+			if (IsReadOnly()) return;
+			if (_member != nullptr) _member->Store(obj, value);
+			else _setter.CallWithArgs(obj, std::span<const Variant>(&value, 1));
+		}
+
+		// Reads the property of every object into the matching element of column, which must be the same length. A data
+		// member holding exactly a V is copied directly, anything else is read with Get and converted. Returns false
+		// without reading anything if any object is not of the handle's class.
+		template <typename V> requires (Variant::TypeOf<V>() != Variant::Empty)
+		bool Export(std::span<Object* const> objects, std::span<V> column) const {
+			if (!IsValid() || objects.size() != column.size() || !_allInstances(objects)) return false;
+			if (_member != nullptr && _member->type == Variant::TypeOf<V>() && _member->size == sizeof(V)) {
+				for (size_t i = 0; i < objects.size(); i++) {
+					const void* value = _member->Address(objects[i]);
+					if constexpr (std::is_trivially_copyable_v<V>) memcpy(&column[i], value, sizeof(V));
+					else column[i] = *static_cast<const V*>(value);
+				}
+				return true;
 			}
-			else {
-				return call_class_method_helper<R, T, Args...>(static_cast<T*>(obj), method, args, methodMetadata.requiredArgCount, methodMetadata.defaultArgValues, success);
+			for (size_t i = 0; i < objects.size(); i++) {
+				column[i] = static_cast<V>(Get(objects[i]));
 			}
+			return true;
 		}
-		
-		BindedObjectMethod(R(T::* met)(Args...) const, ObjectRTTIModel::ObjectMethodDefinition methodInfo): ObjectMethod(methodInfo) {
-			constMethod = met;
-			_isConst = true;
-		}
-		BindedObjectMethod(R(T::* met)(Args...), ObjectRTTIModel::ObjectMethodDefinition methodInfo) : ObjectMethod(methodInfo) {
-			method = met;
-			_isConst = false;
+
+		// Writes each element of column to the property of the matching object, see Export.
+		template <typename V> requires (Variant::TypeOf<V>() != Variant::Empty)
+		bool Import(std::span<Object* const> objects, std::span<const V> column) const {
+			if (!IsValid() || IsReadOnly() || objects.size() != column.size() || !_allInstances(objects)) return false;
+			if (_member != nullptr && _member->type == Variant::TypeOf<V>() && _member->size == sizeof(V)) {
+				for (size_t i = 0; i < objects.size(); i++) {
+					void* value = _member->Address(objects[i]);
+					if constexpr (std::is_trivially_copyable_v<V>) memcpy(value, &column[i], sizeof(V));
+					else *static_cast<V*>(value) = column[i];
+				}
+				return true;
+			}
+			for (size_t i = 0; i < objects.size(); i++) {
+				Set(objects[i], Variant(column[i]));
+			}
+			return true;
 		}
 	};
 
@@ -141,61 +343,153 @@ namespace engine_type_registry {
 		friend class type_registry;
 		friend class Object;
 		private:
-		string _className = "";
-		string _parentClassName = "";
+		StringName _className{};
+		StringName _parentClassName{};
 		EngineClass* _inherits = nullptr;
-		map<string, ObjectRTTIModel::ObjectMethodDefinition> _methods{};
-		map<string, ObjectMethod*> _methodBinds{};
+		// Classes are numbered in depth first pre-order by type_registry::build_lookup_tables, so the classes derived
+		// from this one are exactly those with ids from _classId + 1 to _lastDescendantId.
+		uint32_t _classId = UINT32_MAX;
+		uint32_t _lastDescendantId = UINT32_MAX;
+		// The class's _ClassIdStatic, which is given the id once it is assigned.
+		uint32_t* _classIdSlot = nullptr;
+		// The class's _PoolStatic, which every object of the class is allocated from.
+		ObjectPool* _pool = nullptr;
+		// Bound methods and members are held by value. Map nodes do not move, so the lookup tables can point into them.
+		map<string, ObjectMethod> _methodBinds{};
 		map<string, ObjectRTTIModel::ObjectPropertyDefinition> _properties{};
+		map<string, ObjectMember> _memberBinds{};
+		// Every method and property of the class and its ancestors, the most derived definition winning. Built by
+		// type_registry::build_lookup_tables once all classes are registered.
+		NameTable<const ObjectMethod*> _allMethods{};
+		NameTable<const PropertyHandle*> _allProperties{};
+		// Handles for every property in _allProperties, sorted by name.
+		std::vector<PropertyHandle> _propertyHandles{};
+		void _buildLookupTables();
 		public:
-		string GetName() const { return _className; }
-		bool HasMethod(string methodName) const { return _methods.contains(methodName); }
+		const StringName& GetName() const { return _className; }
+		uint32_t GetId() const { return _classId; }
+		const ObjectPool* GetPool() const { return _pool; }
+		bool HasMethod(string methodName) const { return _methodBinds.contains(methodName); }
+		const ObjectMethod* FindMethod(const StringName& methodName) const { return _allMethods.Find(methodName); }
+		const ObjectRTTIModel::ObjectPropertyDefinition* FindProperty(const StringName& propertyName) const {
+			const PropertyHandle* handle = _allProperties.Find(propertyName);
+			return handle != nullptr ? &handle->GetDefinition() : nullptr;
+		}
+
+		// Resolve a method or property for repeated use. The returned handle is invalid if the name is not found.
+		MethodHandle ResolveMethod(const StringName& methodName) const { return MethodHandle(_allMethods.Find(methodName)); }
+		PropertyHandle ResolveProperty(const StringName& propertyName) const {
+			const PropertyHandle* handle = _allProperties.Find(propertyName);
+			return handle != nullptr ? *handle : PropertyHandle();
+		}
+		// Every property of the class, including inherited ones, sorted by name.
+		const std::vector<PropertyHandle>& GetProperties() const { return _propertyHandles; }
 		Object* (*_dynamic_constructor)() = nullptr;
 	};
 
 	class type_registry {
 		private:
-		static string _currentClass;
+		static StringName _currentClass;
+		// The record of _currentClass, so registering its methods and properties does not look it up each time.
+		static EngineClass* _currentClassRecord;
+		static vector<EngineClass*> _classesById;
+		static void _assignClassIds();
 		public:
 		static void register_all_types();
-		static void register_new_class(string new_class_name, string parent_class_name = "Object");
+		static void register_new_class(const StringName& new_class_name, const StringName& parent_class_name = "Object");
 		static void end_class() {
-			_currentClass = "";
+			_currentClass = StringName();
+			_currentClassRecord = nullptr;
 		};
-		static map<string, EngineClass> _registered_classes;
+		static unordered_map<StringName, EngineClass> _registered_classes;
+		// Flattens the method and property tables of every registered class. Must be called after registering classes.
+		static void build_lookup_tables();
+		// Returns the registered class with the given name, or nullptr.
+		static EngineClass* find_class(const StringName& className) {
+			unordered_map<StringName, EngineClass>::iterator it = _registered_classes.find(className);
+			return it == _registered_classes.end() ? nullptr : &it->second;
+		}
+		// Returns the registered class with the given id, or nullptr. Ids are assigned by build_lookup_tables.
+		static EngineClass* find_class(uint32_t classId) {
+			return classId < _classesById.size() ? _classesById[classId] : nullptr;
+		}
+		// Whether the class with id classId is the class with id ancestorId or derived from it.
+		static bool is_class_or_derived(uint32_t classId, uint32_t ancestorId) {
+			return ancestorId < _classesById.size() && classId >= ancestorId && classId <= _classesById[ancestorId]->_lastDescendantId;
+		}
+		// Reads or writes one property across many objects of a class, or of classes derived from it, as a contiguous
+		// column. Returns false if the property does not exist, the lengths differ, an object is not of the class, or on
+		// import the property is read only.
+		template <typename V>
+		static bool export_property(const StringName& className, const StringName& propertyName, std::span<Object* const> objects, std::span<V> column) {
+			return resolve_property(className, propertyName).Export(objects, column);
+		}
+		template <typename V>
+		static bool import_property(const StringName& className, const StringName& propertyName, std::span<Object* const> objects, std::span<const V> column) {
+			return resolve_property(className, propertyName).Import(objects, column);
+		}
+		static MethodHandle resolve_method(const StringName& className, const StringName& methodName) {
+			EngineClass* cls = find_class(className);
+			return cls != nullptr ? cls->ResolveMethod(methodName) : MethodHandle();
+		}
+		static PropertyHandle resolve_property(const StringName& className, const StringName& propertyName) {
+			EngineClass* cls = find_class(className);
+			return cls != nullptr ? cls->ResolveProperty(propertyName) : PropertyHandle();
+		}
 
 		template <typename T>
 		static void register_class() {
 			T::_register_type();
 			EngineClass* cls = &_registered_classes[T::_ClassNameStatic()];
 			cls->_dynamic_constructor = &(dynamic_constructor<T>);
+			cls->_classIdSlot = &T::_ClassIdStatic();
+			cls->_pool = &T::_PoolStatic();
 			return;
 		};
 
 		template <typename R, typename T, typename... Args> requires IsDerivedFromObject<T>
 		static void class_expose_method(ObjectRTTIModel::ObjectMethodDefinition methodInfo, R(T::* func)(Args...)) {
-			if (_registered_classes[_currentClass]._methods.contains(methodInfo.methodName)) {
-				Log.Warn("TypeRegistry", "Attempted to redefine method " + _currentClass + "::" + methodInfo.methodName);
+			if (_currentClassRecord->_methodBinds.contains(methodInfo.methodName)) {
+				Log.Warn("TypeRegistry", "Attempted to redefine method " + _currentClass.String() + "::" + methodInfo.methodName);
 				return;
 			}
-			_registered_classes[_currentClass]._methods[methodInfo.methodName] = methodInfo;
-			_registered_classes[_currentClass]._methodBinds[methodInfo.methodName] = new BindedObjectMethod<R, T, Args...>(func, methodInfo);
+			string methodName = methodInfo.methodName;
+			_currentClassRecord->_methodBinds.emplace(std::move(methodName), ObjectMethod(func, std::move(methodInfo)));
 			return;
 		};
 
 		// Overload to expose member functions declared const
 		template <typename R, typename T, typename... Args> requires IsDerivedFromObject<T>
 		static void class_expose_method(ObjectRTTIModel::ObjectMethodDefinition methodInfo, R(T::* func)(Args...) const) {
-			if (_registered_classes[_currentClass]._methods.contains(methodInfo.methodName)) {
-				Log.Warn("TypeRegistry", "Attempted to redefine method " + _currentClass + "::" + methodInfo.methodName);
+			if (_currentClassRecord->_methodBinds.contains(methodInfo.methodName)) {
+				Log.Warn("TypeRegistry", "Attempted to redefine method " + _currentClass.String() + "::" + methodInfo.methodName);
 				return;
 			}
-			_registered_classes[_currentClass]._methods[methodInfo.methodName] = methodInfo;
-			_registered_classes[_currentClass]._methodBinds[methodInfo.methodName] = new BindedObjectMethod<R, T, Args...>(func, methodInfo);
+			string methodName = methodInfo.methodName;
+			_currentClassRecord->_methodBinds.emplace(std::move(methodName), ObjectMethod(func, std::move(methodInfo)));
 			return;
 		};
 
 		static void class_define_property(ObjectRTTIModel::ObjectPropertyDefinition def);
 
+		// Defines a property read and written directly through a data member, its type taken from the member's type.
+		template <typename T, typename M> requires IsDerivedFromObject<T> && (Variant::TypeOf<M>() != Variant::Empty)
+		static void class_define_member_property(string propertyName, ObjectRTTIModel::ObjectPropertyDefinition::PropertyFlags flags, M T::* member) {
+			if (_currentClassRecord->_properties.contains(propertyName)) {
+				Log.Warn("TypeRegistry", "Attempted to redefine property " + _currentClass.String() + "::" + propertyName);
+				return;
+			}
+			_currentClassRecord->_properties[propertyName] = ObjectRTTIModel::ObjectPropertyDefinition(propertyName, Variant::TypeOf<M>(), flags, StringName());
+			_currentClassRecord->_memberBinds.emplace(propertyName, ObjectMember(member));
+		}
+
 	};
-}
\ No newline at end of file
+}
+
+// Returns obj as a T if its class is T or derived from T, otherwise nullptr. A replacement for dynamic_cast between
+// registered classes, which only compares class ids.
+template <typename T> requires IsDerivedFromObject<T>
+static T* object_cast(Object* obj) {
+	if (obj == nullptr || !engine_type_registry::type_registry::is_class_or_derived(obj->_ClassId(), T::_ClassIdStatic())) return nullptr;
+	return static_cast<T*>(obj);
+}
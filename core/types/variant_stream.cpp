@@ -0,0 +1,243 @@
+#include "variant_stream.h"
+#include <cstring>
+
+// Arrays nested deeper than this are treated as corrupt data rather than recursed into.
+constexpr uint32_t MAX_ARRAY_DEPTH = 64;
+
+size_t VariantWriter::SerialisedSize(const Variant& v)
+{
+	size_t size = VARIANT_ENUM_SIZE;
+	switch (v.Type()) {
+		case Variant::Empty:
+		case Variant::Void:
+			break;
+		case Variant::Bool:
+			size += sizeof(uint8_t);
+			break;
+		case Variant::Int32:
+		case Variant::UInt32:
+		case Variant::Float:
+			size += sizeof(int32_t);
+			break;
+		case Variant::Int64:
+		case Variant::UInt64:
+		case Variant::Double:
+			size += sizeof(int64_t);
+			break;
+		case Variant::String:
+			size += sizeof(int32_t) + v.GetStringView().size();
+			break;
+		case Variant::VariantArray:
+			size += sizeof(int32_t);
+			for (const Variant& element : v.GetVariantArrayView()) {
+				size += SerialisedSize(element);
+			}
+			break;
+		default:
+			if (v.IsPackedArray()) {
+				size += sizeof(int32_t) + v.GetPackedArrayBytes().size();
+			}
+			break;
+	}
+	return size;
+}
+
+void VariantWriter::Write(const Variant& v)
+{
+	int32_t tag = static_cast<int32_t>(v.Type());
+	WriteBytes(&tag, VARIANT_ENUM_SIZE);
+
+	switch (v.Type()) {
+		case Variant::Empty:
+		case Variant::Void:
+			return;
+		case Variant::Bool: {
+			uint8_t value = v.Value<bool>() ? 0xFF : 0x00;
+			WriteBytes(&value, sizeof(uint8_t));
+			return;
+		}
+		case Variant::Int32: {
+			int32_t value = v.Value<int32_t>();
+			WriteBytes(&value, sizeof(int32_t));
+			return;
+		}
+		case Variant::UInt32: {
+			uint32_t value = v.Value<uint32_t>();
+			WriteBytes(&value, sizeof(uint32_t));
+			return;
+		}
+		case Variant::Int64: {
+			int64_t value = v.Value<int64_t>();
+			WriteBytes(&value, sizeof(int64_t));
+			return;
+		}
+		case Variant::UInt64: {
+			uint64_t value = v.Value<uint64_t>();
+			WriteBytes(&value, sizeof(uint64_t));
+			return;
+		}
+		case Variant::Float: {
+			float value = v.Value<float>();
+			WriteBytes(&value, sizeof(float));
+			return;
+		}
+		case Variant::Double: {
+			double value = v.Value<double>();
+			WriteBytes(&value, sizeof(double));
+			return;
+		}
+		case Variant::String: {
+			std::string_view str = v.GetStringView();
+			int32_t length = static_cast<int32_t>(str.size());
+			WriteBytes(&length, sizeof(int32_t));
+			WriteBytes(str.data(), str.size());
+			return;
+		}
+		case Variant::VariantArray: {
+			std::span<const Variant> elements = v.GetVariantArrayView();
+			int32_t count = static_cast<int32_t>(elements.size());
+			WriteBytes(&count, sizeof(int32_t));
+			for (const Variant& element : elements) {
+				Write(element);
+			}
+			return;
+		}
+		default:
+			if (v.IsPackedArray()) {
+				std::span<const uint8_t> bytes = v.GetPackedArrayBytes();
+				int32_t count = static_cast<int32_t>(bytes.size() / Variant::PackedArrayElementSize(v.Type()));
+				WriteBytes(&count, sizeof(int32_t));
+				WriteBytes(bytes.data(), bytes.size());
+			}
+			return;
+	}
+}
+
+bool VariantReader::readBytes(void* out, size_t size)
+{
+	if (_failed || size > _data.size() - _position) {
+		if (!_failed) Log.Warn("VariantReader", "Unexpected end of data at offset " + std::to_string(_position));
+		_failed = true;
+		return false;
+	}
+	if (size > 0) memcpy(out, _data.data() + _position, size);
+	_position += size;
+	return true;
+}
+
+Variant VariantReader::Read()
+{
+	return readValue(0);
+}
+
+Variant VariantReader::readValue(uint32_t depth)
+{
+	int32_t tag = 0;
+	if (!readBytes(&tag, VARIANT_ENUM_SIZE)) return Variant();
+	Variant::StoredType type = static_cast<Variant::StoredType>(tag);
+
+	switch (type) {
+		case Variant::Empty:
+		case Variant::Void:
+			return Variant(type);
+		case Variant::Bool: {
+			uint8_t value = 0;
+			if (!readBytes(&value, sizeof(uint8_t))) return Variant();
+			return value == 0xFF;
+		}
+		case Variant::Int32: {
+			int32_t value = 0;
+			if (!readBytes(&value, sizeof(int32_t))) return Variant();
+			return value;
+		}
+		case Variant::UInt32: {
+			uint32_t value = 0;
+			if (!readBytes(&value, sizeof(uint32_t))) return Variant();
+			return value;
+		}
+		case Variant::Int64: {
+			int64_t value = 0;
+			if (!readBytes(&value, sizeof(int64_t))) return Variant();
+			return value;
+		}
+		case Variant::UInt64: {
+			uint64_t value = 0;
+			if (!readBytes(&value, sizeof(uint64_t))) return Variant();
+			return value;
+		}
+		case Variant::Float: {
+			float value = 0;
+			if (!readBytes(&value, sizeof(float))) return Variant();
+			return value;
+		}
+		case Variant::Double: {
+			double value = 0;
+			if (!readBytes(&value, sizeof(double))) return Variant();
+			return value;
+		}
+		case Variant::String: {
+			int32_t length = 0;
+			if (!readBytes(&length, sizeof(int32_t))) return Variant();
+			if (length < 0 || static_cast<size_t>(length) > _data.size() - _position) break;
+			std::string_view str(reinterpret_cast<const char*>(_data.data() + _position), length);
+			_position += length;
+			return str;
+		}
+		case Variant::VariantArray: {
+			int32_t count = 0;
+			if (!readBytes(&count, sizeof(int32_t))) return Variant();
+			// Every element takes at least its tag, which bounds the count before anything is allocated.
+			if (count < 0 || depth >= MAX_ARRAY_DEPTH || static_cast<size_t>(count) > (_data.size() - _position) / VARIANT_ENUM_SIZE) break;
+			std::vector<Variant> elements;
+			elements.reserve(count);
+			for (int32_t i = 0; i < count; i++) {
+				elements.push_back(readValue(depth + 1));
+				if (_failed) return Variant();
+			}
+			return elements;
+		}
+		default: {
+			size_t elementSize = Variant::PackedArrayElementSize(type);
+			if (elementSize == 0) break;
+			int32_t count = 0;
+			if (!readBytes(&count, sizeof(int32_t))) return Variant();
+			if (count < 0 || static_cast<size_t>(count) > (_data.size() - _position) / elementSize) break;
+			Variant array = Variant::CreatePackedArray(type, count);
+			std::span<uint8_t> bytes = array.GetMutablePackedArrayBytes();
+			readBytes(bytes.data(), bytes.size());
+			return array;
+		}
+	}
+
+	Log.Warn("VariantReader", "Invalid or corrupt value of type " + std::to_string(tag) + " at offset " + std::to_string(_position));
+	_failed = true;
+	return Variant();
+}
+
+bool VariantReader::ReadNumeric(Variant::StoredType type, void* out)
+{
+	size_t size = Variant::NumericSize(type);
+	if (_failed || size == 0 || VARIANT_ENUM_SIZE + size > _data.size() - _position) return false;
+	int32_t tag = 0;
+	memcpy(&tag, _data.data() + _position, VARIANT_ENUM_SIZE);
+	if (tag != static_cast<int32_t>(type)) return false;
+	memcpy(out, _data.data() + _position + VARIANT_ENUM_SIZE, size);
+	_position += VARIANT_ENUM_SIZE + size;
+	return true;
+}
+
+std::string_view VariantReader::ReadCString()
+{
+	if (_failed) return {};
+	const char* start = reinterpret_cast<const char*>(_data.data() + _position);
+	size_t remaining = _data.size() - _position;
+	const void* terminator = memchr(start, 0x00, remaining);
+	if (terminator == nullptr) {
+		Log.Warn("VariantReader", "Unterminated string at offset " + std::to_string(_position));
+		_failed = true;
+		return {};
+	}
+	size_t length = static_cast<const char*>(terminator) - start;
+	_position += length + 1;
+	return std::string_view(start, length);
+}
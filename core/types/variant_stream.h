@@ -0,0 +1,72 @@
+#pragma once
+#include "variant_type.h"
+#include <vector>
+#include <span>
+#include <string_view>
+
+// Binary serialisation of Variants into and out of a caller-owned byte buffer.
+// Every value is written as its StoredType tag (VARIANT_ENUM_SIZE bytes) followed by its payload:
+//	Bool - one byte, 0xFF or 0x00.
+//	Numeric types - the raw value.
+//	String - int32_t length, then the characters without a terminator.
+//	VariantArray - int32_t element count, then each element as a tagged value.
+//	Packed arrays - int32_t element count, then the raw element data.
+// Empty and Void have no payload.
+
+// Appends serialised values to the end of a byte buffer, without allocating per value.
+class VariantWriter {
+	private:
+	std::vector<uint8_t>& _buffer;
+
+	public:
+	VariantWriter(std::vector<uint8_t>& buffer) : _buffer(buffer) {}
+
+	// Number of bytes Write will append for v, so a buffer can be grown once for many values.
+	static size_t SerialisedSize(const Variant& v);
+
+	void Write(const Variant& v);
+	void WriteBytes(const void* data, size_t size) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		_buffer.insert(_buffer.end(), bytes, bytes + size);
+	}
+	// Writes a value of a numeric type straight from memory holding it, see Variant::NumericSize.
+	void WriteNumeric(Variant::StoredType type, const void* data) {
+		int32_t tag = static_cast<int32_t>(type);
+		WriteBytes(&tag, VARIANT_ENUM_SIZE);
+		WriteBytes(data, Variant::NumericSize(type));
+	}
+	// Writes the characters of str followed by a null terminator.
+	void WriteCString(std::string_view str) {
+		WriteBytes(str.data(), str.size());
+		_buffer.push_back(0x00);
+	}
+
+	void Reserve(size_t additionalBytes) { _buffer.reserve(_buffer.size() + additionalBytes); }
+	size_t Size() const { return _buffer.size(); }
+};
+
+// Reads serialised values sequentially from a byte buffer. Reading past the end of the buffer or an unknown type tag
+// logs a warning and puts the reader in a failed state, in which every further read returns an Empty Variant.
+class VariantReader {
+	private:
+	std::span<const uint8_t> _data;
+	size_t _position = 0;
+	bool _failed = false;
+
+	bool readBytes(void* out, size_t size);
+	Variant readValue(uint32_t depth);
+
+	public:
+	VariantReader(std::span<const uint8_t> data) : _data(data) {}
+
+	Variant Read();
+	// Reads a value of the numeric type into out, if the next value has that type. Otherwise nothing is read and false
+	// is returned, so the value can still be read with Read.
+	bool ReadNumeric(Variant::StoredType type, void* out);
+	// Reads up to the next null terminator. The returned view points into the buffer.
+	std::string_view ReadCString();
+
+	bool AtEnd() const { return _failed || _position >= _data.size(); }
+	bool Failed() const { return _failed; }
+	size_t Position() const { return _position; }
+};
@@ -1,7 +1,8 @@
 #include "variant_type.h"
 
 #include <cstring>
-#include <regex>
+#include <charconv>
+#include <algorithm>
 
 bool Variant::_same(const Variant& v1, const Variant& v2)
 {
@@ -25,114 +26,41 @@ bool Variant::_same(const Variant& v1, const Variant& v2)
 		case StoredType::Double:
 			return v1.Value<double>() == v2.Value<double>();
 		case StoredType::String:
-			return v1.Value<std::string>() == v2.Value<std::string>();
-		case StoredType::VariantArray: 
-			return v1.Value<std::vector<Variant>>() == v2.Value<std::vector<Variant>>();
+			return v1.GetStringView() == v2.GetStringView();
+		case StoredType::VariantArray: {
+			std::span<const Variant> a1 = v1.GetVariantArrayView();
+			std::span<const Variant> a2 = v2.GetVariantArrayView();
+			return a1.data() == a2.data() || std::equal(a1.begin(), a1.end(), a2.begin(), a2.end());
+		}
+	}
+	if (v1.IsPackedArray()) {
+		// Packed arrays compare bitwise, a single memcmp over the contiguous data.
+		std::span<const uint8_t> a1 = v1.GetPackedArrayBytes();
+		std::span<const uint8_t> a2 = v2.GetPackedArrayBytes();
+		return a1.size() == a2.size() && (a1.data() == a2.data() || memcmp(a1.data(), a2.data(), a1.size()) == 0);
 	}
 	return false;
 }
 
-char* Variant::BinarySerialise(Variant v)
+Variant Variant::CreatePackedArray(StoredType type, size_t count)
 {
-	char* buffer;
-	short typeVal = static_cast<short>(v._currentType);
-	switch (v.Type()) {
-		case StoredType::Empty:
-		case StoredType::Void:
-			buffer = new char[VARIANT_ENUM_SIZE];
-			memcpy(buffer, &typeVal, VARIANT_ENUM_SIZE);
-			buffer[0] = static_cast<char>(v.Type());
-			return buffer;
-		case StoredType::Bool:
-			buffer = new char[VARIANT_ENUM_SIZE + 1];
-			memcpy(buffer, &typeVal, VARIANT_ENUM_SIZE);
-			buffer[VARIANT_ENUM_SIZE] = v.Value<bool>() ? 0xFF : 0x00;
-			return buffer;
-		case StoredType::Int32:
-			buffer = new char[VARIANT_ENUM_SIZE + sizeof(int32_t)];
-			memcpy(buffer, &typeVal, VARIANT_ENUM_SIZE);
-			memcpy(buffer + VARIANT_ENUM_SIZE, &v._primitiveData, sizeof(int32_t));
-			return buffer;
-		case StoredType::UInt32:
-			buffer = new char[VARIANT_ENUM_SIZE + sizeof(uint32_t)];
-			memcpy(buffer, &typeVal, VARIANT_ENUM_SIZE);
-			memcpy(buffer + VARIANT_ENUM_SIZE, &v._primitiveData, sizeof(uint32_t));
-			return buffer;
-		case StoredType::Int64:
-			buffer = new char[VARIANT_ENUM_SIZE + sizeof(int64_t)];
-			memcpy(buffer, &typeVal, VARIANT_ENUM_SIZE);
-			memcpy(buffer + VARIANT_ENUM_SIZE, &v._primitiveData, sizeof(int64_t));
-			return buffer;
-		case StoredType::UInt64:
-			buffer = new char[VARIANT_ENUM_SIZE + sizeof(uint64_t)];
-			memcpy(buffer, &typeVal, VARIANT_ENUM_SIZE);
-			memcpy(buffer + VARIANT_ENUM_SIZE, &v._primitiveData, sizeof(uint64_t));
-			return buffer;
-		case StoredType::Float:
-			buffer = new char[VARIANT_ENUM_SIZE + sizeof(float)];
-			memcpy(buffer, &typeVal, VARIANT_ENUM_SIZE);
-			memcpy(buffer + VARIANT_ENUM_SIZE, &v._primitiveData, sizeof(float));
-			return buffer;
-		case StoredType::Double:
-			buffer = new char[VARIANT_ENUM_SIZE + sizeof(double)];
-			memcpy(buffer, &typeVal, VARIANT_ENUM_SIZE);
-			memcpy(buffer + VARIANT_ENUM_SIZE, &v._primitiveData, sizeof(double));
-			return buffer;
-		case StoredType::String:
-			string* stringPtr = (string*)v._primitiveData._ptr;
-			int32_t size = static_cast<int32_t>(stringPtr->size());
-			buffer = new char[VARIANT_ENUM_SIZE + sizeof(int32_t) + size];
-			memcpy(buffer, &typeVal, VARIANT_ENUM_SIZE);
-			memcpy(buffer + VARIANT_ENUM_SIZE, &size, sizeof(int32_t));
-			memcpy(buffer + VARIANT_ENUM_SIZE + sizeof(int32_t), stringPtr->data(), size);
-			return buffer;
-	}
-	throw runtime_error("");
-}
-
-int32_t Variant::BinarySerialisationLength(char* bin) {
-	short* typeBin = new short;
-	memcpy(typeBin, bin, VARIANT_ENUM_SIZE);
-	Variant::StoredType type = static_cast<Variant::StoredType>(*typeBin);
-	delete typeBin;
-	int32_t len = 0;
 	switch (type) {
-		case StoredType::Empty:
-		case StoredType::Void:
-			len = 0;
-			break;
-		case StoredType::Bool:
-			len = sizeof(char);
-			break;
-		case StoredType::Int32:
-			len = sizeof(int32_t);
-			break;
-		case StoredType::UInt32:
-			len = sizeof(uint32_t);
-			break;
-		case StoredType::Int64:
-			len = sizeof(int64_t);
-			break;
-		case StoredType::UInt64:
-			len = sizeof(uint64_t);
-			break;
-		case StoredType::Float:
-			len = sizeof(float);
-			break;
-		case StoredType::Double:
-			len = sizeof(double);
-			break;
-		case StoredType::String:
-			int32_t size = 0;
-			memcpy(&size, bin + VARIANT_ENUM_SIZE, sizeof(int32_t));
-			len = sizeof(int32_t) + sizeof(char) * size;
-			break;
+		case StoredType::ByteArray: return std::vector<uint8_t>(count);
+		case StoredType::UInt32Array: return std::vector<uint32_t>(count);
+		case StoredType::Int32Array: return std::vector<int32_t>(count);
+		case StoredType::Int64Array: return std::vector<int64_t>(count);
+		case StoredType::FloatArray: return std::vector<float>(count);
+		case StoredType::DoubleArray: return std::vector<double>(count);
+		case StoredType::Vector2Array: return std::vector<Vector2>(count);
+		case StoredType::Vector3Array: return std::vector<Vector3>(count);
+		case StoredType::Vector4Array: return std::vector<Vector4>(count);
+		default:
+			Log.Error("Variant", "Cannot create a packed array of type " + VariantTypeToString(type));
+			return Variant(StoredType::Empty);
 	}
-	return len + VARIANT_ENUM_SIZE;
 }
 
-
-std::string Variant::StringSerialise(Variant v)
+std::string Variant::StringSerialise(const Variant& v)
 {
 	switch (v.Type()) {
 		case StoredType::Empty:
@@ -152,52 +80,79 @@ std::string Variant::StringSerialise(Variant v)
 			return "Float" + std::to_string(v.Value<float>());
 		case StoredType::Double:
 			return "Double" + std::to_string(v.Value<double>());
-		case StoredType::String:
-			return "\"" + v.Value<string>() + "\"";
+		case StoredType::String: {
+			std::string_view str = v.GetStringView();
+			string quoted;
+			quoted.reserve(str.size() + 2);
+			quoted += '"';
+			quoted += str;
+			quoted += '"';
+			return quoted;
+		}
 	}
 	return "";
 }
 
-Variant Variant::FromString(std::string* str)
+// Parses a whole string_view as a number of type T, failing if any characters are left over.
+template <typename T>
+static bool parse_number(std::string_view str, T& out)
 {
-	std::regex pattern (R"(^([A-Za-z]+)(.+);$)");
-	std::smatch match;
+	const char* end = str.data() + str.size();
+	std::from_chars_result result = std::from_chars(str.data(), end, out);
+	return result.ec == std::errc() && result.ptr == end;
+}
 
-	if (!std::regex_search(*str, match, pattern)) {
-		return Variant(Variant::Empty);
-	}
+template <typename T>
+static Variant parse_number_variant(std::string_view str)
+{
+	T value{};
+	if (!parse_number(str, value)) return Variant(Variant::Empty);
+	return Variant(value);
+}
 
-	string type = match[1];
-	string content = match[2];
+Variant Variant::FromString(std::string_view str)
+{
+	// Values in resource files may be terminated by ';'.
+	if (!str.empty() && str.back() == ';') str.remove_suffix(1);
+	if (str.empty()) return Variant(Variant::Void);
 
-	if ((*str).starts_with(";")) {
-		return Variant(Variant::Void);
-	}
-	else if (type == "Bool") {
-		return Variant(content == "1" ? true : false);
-	}
-	else if (type == "Int32") {
-		return Variant(std::stoi(content));
-	}
-	else if (type == "UInt32") {
-		return Variant(static_cast<uint32_t>(std::stoul(content)));
-	}
-	else if (type == "LLong") {
-		return Variant(std::stoll(content));
-	}
-	else if (type == "ULLong") {
-		return Variant(std::stoull(content));
-	}
-	else if (type == "Float") {
-		return Variant(std::stof(content));
-	}
-	else if (type == "Double") {
-		return Variant(std::stod(content));
-	}
-	else if (type == "String") {
-		content.pop_back();
-		return Variant(content.substr(1));
+	switch (str.front()) {
+		case '"':
+			if (str.size() < 2 || str.back() != '"') break;
+			return Variant(str.substr(1, str.size() - 2));
+		case 'n':
+			if (str == "null") return Variant(Variant::Void);
+			break;
+		case 't':
+			if (str == "true") return Variant(true);
+			break;
+		case 'f':
+			if (str == "false") return Variant(false);
+			break;
+		case 'B':
+			if (str == "Bool1") return Variant(true);
+			if (str == "Bool0") return Variant(false);
+			break;
+		case 'I':
+			if (str.starts_with("Int32")) return parse_number_variant<int32_t>(str.substr(5));
+			break;
+		case 'U':
+			if (str.starts_with("UInt32")) return parse_number_variant<uint32_t>(str.substr(6));
+			if (str.starts_with("ULLong")) return parse_number_variant<uint64_t>(str.substr(6));
+			break;
+		case 'L':
+			if (str.starts_with("Llong") || str.starts_with("LLong")) return parse_number_variant<int64_t>(str.substr(5));
+			break;
+		case 'F':
+			if (str.starts_with("Float")) return parse_number_variant<float>(str.substr(5));
+			break;
+		case 'D':
+			if (str.starts_with("Double")) return parse_number_variant<double>(str.substr(6));
+			break;
+		case 'S':
+			if (str.starts_with("String\"") && str.size() >= 8 && str.back() == '"') return Variant(str.substr(7, str.size() - 8));
+			break;
 	}
 
 	return Variant(Variant::Empty);
-}
\ No newline at end of file
+}
@@ -4,14 +4,47 @@
 #include <concepts>
 #include <type_traits>
 #include <vector>
+#include <cstring>
+#include <atomic>
+#include <string_view>
+#include <span>
+#include <bit>
 
 
 template <typename T>
 concept IsIntegerEnum = (std::is_enum<T>::value) && (std::is_same_v<std::underlying_type_t<T>, int32_t>);
 
+// Fixed width float vectors, element types of the packed vector array kinds. Layout compatible with glm::vec2/3/4.
+struct Vector2 {
+	float x = 0, y = 0;
+	friend bool operator==(const Vector2&, const Vector2&) = default;
+};
+
+struct Vector3 {
+	float x = 0, y = 0, z = 0;
+	friend bool operator==(const Vector3&, const Vector3&) = default;
+};
+
+struct Vector4 {
+	float x = 0, y = 0, z = 0, w = 0;
+	friend bool operator==(const Vector4&, const Vector4&) = default;
+};
+
+template <typename T>
+concept IsPackedElement = std::is_same_v<T, uint8_t> || std::is_same_v<T, uint32_t> || std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+	std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, Vector2> || std::is_same_v<T, Vector3> || std::is_same_v<T, Vector4>;
+
+template <typename T>
+struct is_packed_vector : std::false_type {};
+template <typename T>
+struct is_packed_vector<std::vector<T>> : std::bool_constant<IsPackedElement<T>> {};
+
+template <typename T>
+concept IsPackedVector = is_packed_vector<T>::value;
+
 // Implementation of a variant data type, which can dynamically hold primitve data types, used to correctly cast data for use with RTTI.
 struct Variant {
-	enum StoredType: short {
+	enum StoredType: int32_t {
 		// NOTE: Empty and Void represent two different types - A variant that has not been assigned, vs an assigned variant holding nothing.
 		Empty = 0,
 		Void = (1u << 0),
@@ -29,7 +62,16 @@ struct Variant {
 		String = (1u << 8),
 		VariantArray = (1u << 9),
 		UInt32Array = (1u << 10),
-		// WIP
+
+		// Packed array types, each a contiguous std::vector of plain values:
+		ByteArray = (1u << 11),
+		Int32Array = (1u << 12),
+		Int64Array = (1u << 13),
+		FloatArray = (1u << 14),
+		DoubleArray = (1u << 15),
+		Vector2Array = (1u << 16),
+		Vector3Array = (1u << 17),
+		Vector4Array = (1u << 18),
 
 	};
 
@@ -59,147 +101,402 @@ struct Variant {
 				return "VariantArray";
 			case StoredType::UInt32Array:
 				return "UInt32Array";
+			case StoredType::ByteArray:
+				return "ByteArray";
+			case StoredType::Int32Array:
+				return "Int32Array";
+			case StoredType::Int64Array:
+				return "Int64Array";
+			case StoredType::FloatArray:
+				return "FloatArray";
+			case StoredType::DoubleArray:
+				return "DoubleArray";
+			case StoredType::Vector2Array:
+				return "Vector2Array";
+			case StoredType::Vector3Array:
+				return "Vector3Array";
+			case StoredType::Vector4Array:
+				return "Vector4Array";
 			default:
 				return "";
 		}
 	}
 
+	static constexpr int32_t PACKED_ARRAY_TYPES = StoredType::UInt32Array | StoredType::ByteArray | StoredType::Int32Array | StoredType::Int64Array |
+		StoredType::FloatArray | StoredType::DoubleArray | StoredType::Vector2Array | StoredType::Vector3Array | StoredType::Vector4Array;
+
+	// Returns the packed array type holding elements of type T, or Empty if there is none.
+	template <typename T>
+	static constexpr StoredType PackedArrayType() {
+		if constexpr (std::is_same_v<T, uint8_t>) return StoredType::ByteArray;
+		else if constexpr (std::is_same_v<T, uint32_t>) return StoredType::UInt32Array;
+		else if constexpr (std::is_same_v<T, int32_t>) return StoredType::Int32Array;
+		else if constexpr (std::is_same_v<T, int64_t>) return StoredType::Int64Array;
+		else if constexpr (std::is_same_v<T, float>) return StoredType::FloatArray;
+		else if constexpr (std::is_same_v<T, double>) return StoredType::DoubleArray;
+		else if constexpr (std::is_same_v<T, Vector2>) return StoredType::Vector2Array;
+		else if constexpr (std::is_same_v<T, Vector3>) return StoredType::Vector3Array;
+		else if constexpr (std::is_same_v<T, Vector4>) return StoredType::Vector4Array;
+		else return StoredType::Empty;
+	}
+
+	// Returns the type a Variant constructed from a T holds, or Empty if a Variant cannot hold a T.
+	template <typename T>
+	static constexpr StoredType TypeOf() {
+		using U = std::remove_cvref_t<T>;
+		if constexpr (IsIntegerEnum<U>) return StoredType::Int32;
+		else if constexpr (std::is_same_v<U, bool>) return StoredType::Bool;
+		else if constexpr (std::is_same_v<U, int32_t>) return StoredType::Int32;
+		else if constexpr (std::is_same_v<U, uint32_t>) return StoredType::UInt32;
+		else if constexpr (std::is_same_v<U, int64_t>) return StoredType::Int64;
+		else if constexpr (std::is_same_v<U, uint64_t>) return StoredType::UInt64;
+		else if constexpr (std::is_same_v<U, float>) return StoredType::Float;
+		else if constexpr (std::is_same_v<U, double>) return StoredType::Double;
+		else if constexpr (std::is_same_v<U, string>) return StoredType::String;
+		else if constexpr (std::is_same_v<U, std::vector<Variant>>) return StoredType::VariantArray;
+		else if constexpr (IsPackedVector<U>) return PackedArrayType<typename U::value_type>();
+		else return StoredType::Empty;
+	}
+
+	// Size of the value held by the numeric types, which are stored and serialised as their raw bytes. 0 for other types.
+	static constexpr size_t NumericSize(StoredType type) {
+		switch (type) {
+			case StoredType::Int32:
+			case StoredType::UInt32:
+			case StoredType::Float:
+				return sizeof(int32_t);
+			case StoredType::Int64:
+			case StoredType::UInt64:
+			case StoredType::Double:
+				return sizeof(int64_t);
+			default:
+				return 0;
+		}
+	}
+
+	// Size in bytes of one element of a packed array type, or 0 for any other type.
+	static constexpr size_t PackedArrayElementSize(StoredType type) {
+		switch (type) {
+			case StoredType::ByteArray: return sizeof(uint8_t);
+			case StoredType::UInt32Array: return sizeof(uint32_t);
+			case StoredType::Int32Array: return sizeof(int32_t);
+			case StoredType::Int64Array: return sizeof(int64_t);
+			case StoredType::FloatArray: return sizeof(float);
+			case StoredType::DoubleArray: return sizeof(double);
+			case StoredType::Vector2Array: return sizeof(Vector2);
+			case StoredType::Vector3Array: return sizeof(Vector3);
+			case StoredType::Vector4Array: return sizeof(Vector4);
+			default: return 0;
+		}
+	}
+
+	// Strings up to this many characters are stored inside the Variant itself instead of on the heap.
+	static constexpr size_t SHORT_STRING_CAPACITY = 14;
+
 	private:
+	// Types whose data lives in a sharedPayload behind _storage.held.value._ptr, unless a String is short.
+	static constexpr int32_t HEAP_TYPES = StoredType::String | StoredType::VariantArray | PACKED_ARRAY_TYPES;
+
+	// Heap data is reference counted and shared between copies of a Variant, so copying is O(1). A copy that is about
+	// to be modified detaches first by duplicating the data, see _mutablePayload.
+	struct sharedPayloadBase {
+		std::atomic<uint32_t> refCount = 1;
+		virtual ~sharedPayloadBase() {}
+	};
 
-	union variantData {
-		bool _bool;
-		int32_t _int;
-		uint32_t _uint;
-		int64_t _llong;
-		uint64_t _ullong;
-		float _float;
-		double _double;
+	template <typename T>
+	struct sharedPayload : sharedPayloadBase {
+		T value;
+		sharedPayload(T&& v) : value(std::move(v)) {}
+		sharedPayload(const T& v) : value(v) {}
+	};
 
-		void* _ptr;	
-	} _primitiveData;
+	// Both members of the storage union begin with the type byte, so it can be read whichever member is active. The byte
+	// holds the index of the type's bit plus one (0 for Empty), with SHORT_STRING_FLAG set when a String is held in
+	// shortString rather than behind _ptr. This keeps a Variant, short strings included, within 16 bytes.
+	static constexpr uint8_t SHORT_STRING_FLAG = 0x80;
+
+	struct heldValue {
+		uint8_t typeByte;
+		union {
+			bool _bool;
+			int32_t _int;
+			uint32_t _uint;
+			int64_t _llong;
+			uint64_t _ullong;
+			float _float;
+			double _double;
+
+			sharedPayloadBase* _ptr;
+		} value;
+	};
 
-	StoredType _currentType;
+	struct shortStringValue {
+		uint8_t typeByte;
+		uint8_t size;
+		char data[SHORT_STRING_CAPACITY];
+	};
+
+	union variantStorage {
+		heldValue held;
+		shortStringValue shortString;
+	} _storage;
+
+	StoredType _currentType() const {
+		return static_cast<StoredType>((1u << (_storage.held.typeByte & ~SHORT_STRING_FLAG)) >> 1);
+	}
+	void _setType(StoredType type) {
+		_storage.held.typeByte = type == StoredType::Empty ? 0 : static_cast<uint8_t>(std::countr_zero(static_cast<uint32_t>(type)) + 1);
+	}
+	bool _isShortString() const {
+		return _storage.held.typeByte & SHORT_STRING_FLAG;
+	}
 
 	static bool _same(const Variant& v1, const Variant& v2);
 
+	bool _isShared() const {
+		return (_currentType() & HEAP_TYPES) && !_isShortString();
+	}
+
+	template <typename T, typename A>
+	void _setPayload(StoredType type, A&& value) {
+		_setType(type);
+		_storage.held.value._ptr = new sharedPayload<T>(std::forward<A>(value));
+	}
+
+	template <typename T>
+	const T& _payload() const {
+		return static_cast<sharedPayload<T>*>(_storage.held.value._ptr)->value;
+	}
+
+	// Returns the payload for writing, first duplicating it if any other Variant still references it.
+	template <typename T>
+	T& _mutablePayload() {
+		sharedPayload<T>* payload = static_cast<sharedPayload<T>*>(_storage.held.value._ptr);
+		if (payload->refCount.load(std::memory_order_acquire) > 1) {
+			sharedPayload<T>* copy = new sharedPayload<T>(payload->value);
+			if (payload->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) delete payload;
+			_storage.held.value._ptr = copy;
+			return copy->value;
+		}
+		return payload->value;
+	}
+
+	void _setString(const char* data, size_t size) {
+		if (size <= SHORT_STRING_CAPACITY) {
+			_setType(StoredType::String);
+			_storage.shortString.typeByte |= SHORT_STRING_FLAG;
+			memcpy(_storage.shortString.data, data, size);
+			_storage.shortString.size = static_cast<uint8_t>(size);
+		}
+		else {
+			_setPayload<string>(StoredType::String, string(data, size));
+		}
+	}
+
+	void _copyFrom(const Variant& other) {
+		_storage = other._storage;
+		if (_isShared()) {
+			_storage.held.value._ptr->refCount.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void _release() {
+		if (_isShared() && _storage.held.value._ptr->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			delete _storage.held.value._ptr;
+		}
+		_storage.held.typeByte = 0;
+		_storage.held.value._llong = 0;
+	}
+
+	// Calls f with the std::vector held by a packed array Variant.
+	template <typename F>
+	decltype(auto) _visitPackedArray(F&& f) const {
+		switch (_currentType()) {
+			case StoredType::UInt32Array: return f(_payload<std::vector<uint32_t>>());
+			case StoredType::Int32Array: return f(_payload<std::vector<int32_t>>());
+			case StoredType::Int64Array: return f(_payload<std::vector<int64_t>>());
+			case StoredType::FloatArray: return f(_payload<std::vector<float>>());
+			case StoredType::DoubleArray: return f(_payload<std::vector<double>>());
+			case StoredType::Vector2Array: return f(_payload<std::vector<Vector2>>());
+			case StoredType::Vector3Array: return f(_payload<std::vector<Vector3>>());
+			case StoredType::Vector4Array: return f(_payload<std::vector<Vector4>>());
+			default: return f(_payload<std::vector<uint8_t>>());
+		}
+	}
+
+	const char* _stringData() const {
+		return _isShortString() ? _storage.shortString.data : _payload<string>().data();
+	}
+
+	size_t _stringSize() const {
+		return _isShortString() ? _storage.shortString.size : _payload<string>().size();
+	}
+
 	public:
-	StoredType Type() const { return _currentType; }
+	StoredType Type() const { return _currentType(); }
 
 	template <typename T>
 	T Value() const {
 		return operator T();
 	};
 
+	// Return the held array for in-place modification, duplicating it first if it is shared with other copies.
+	// A Variant holding any other type is replaced by an empty array.
+	std::vector<Variant>& GetMutableVariantArray() {
+		if (_currentType() != StoredType::VariantArray) {
+			_release();
+			_setPayload<std::vector<Variant>>(StoredType::VariantArray, std::vector<Variant>{});
+		}
+		return _mutablePayload<std::vector<Variant>>();
+	}
+
+	std::vector<uint32_t>& GetMutableUInt32Array() {
+		return GetMutablePackedArray<uint32_t>();
+	}
+
+	template <typename T> requires IsPackedElement<T>
+	std::vector<T>& GetMutablePackedArray() {
+		if (_currentType() != PackedArrayType<T>()) {
+			_release();
+			_setPayload<std::vector<T>>(PackedArrayType<T>(), std::vector<T>{});
+		}
+		return _mutablePayload<std::vector<T>>();
+	}
+
+	// Creates a packed array of the given type holding count zeroed elements.
+	static Variant CreatePackedArray(StoredType type, size_t count);
+
+	// Raw bytes of a packed array, for copying the whole array in or out at once.
+	std::span<uint8_t> GetMutablePackedArrayBytes() {
+		if (!IsPackedArray()) return {};
+		// Detach from other copies before handing out write access.
+		switch (_currentType()) {
+			case StoredType::UInt32Array: _mutablePayload<std::vector<uint32_t>>(); break;
+			case StoredType::Int32Array: _mutablePayload<std::vector<int32_t>>(); break;
+			case StoredType::Int64Array: _mutablePayload<std::vector<int64_t>>(); break;
+			case StoredType::FloatArray: _mutablePayload<std::vector<float>>(); break;
+			case StoredType::DoubleArray: _mutablePayload<std::vector<double>>(); break;
+			case StoredType::Vector2Array: _mutablePayload<std::vector<Vector2>>(); break;
+			case StoredType::Vector3Array: _mutablePayload<std::vector<Vector3>>(); break;
+			case StoredType::Vector4Array: _mutablePayload<std::vector<Vector4>>(); break;
+			default: _mutablePayload<std::vector<uint8_t>>(); break;
+		}
+		std::span<const uint8_t> bytes = GetPackedArrayBytes();
+		return std::span<uint8_t>(const_cast<uint8_t*>(bytes.data()), bytes.size());
+	}
+
 	// Returns true if the value seems to be false like or 0 like.
-	bool IsValueFalseLike() inline const {
+	inline bool IsValueFalseLike() const {
 		if (IsEmptyOrVoid()) return true;
-		switch (_currentType) {
+		switch (_currentType()) {
 			case StoredType::String:
-				return ((string*)_primitiveData._ptr)->empty();
+				return _stringSize() == 0;
 			case StoredType::VariantArray:
-				return ((std::vector<Variant>*)_primitiveData._ptr)->empty();
+				return _payload<std::vector<Variant>>().empty();
 			default:
+				if (IsPackedArray()) return GetPackedArrayBytes().empty();
 				return operator bool() == false;
 		}
 	}
 
 
-	bool IsEmptyOrVoid() inline const {
-		return _currentType & (StoredType::Void | StoredType::Empty);
+	inline bool IsString() const {
+		return _currentType() == StoredType::String;
+	}
+
+	inline bool IsVariantArray() const {
+		return _currentType() == StoredType::VariantArray;
+	}
+
+	inline bool IsUInt32Array() const {
+		return _currentType() == StoredType::UInt32Array;
+	}
+
+	inline bool IsPackedArray() const {
+		return (_currentType() & PACKED_ARRAY_TYPES);
+	}
+
+	inline bool IsArray() const {
+		return (_currentType() & (StoredType::VariantArray | PACKED_ARRAY_TYPES));
+	}
+
+	// Non-owning views of the held data, valid until this Variant is modified or destroyed. They are empty if the
+	// Variant holds a different type.
+	inline std::string_view GetStringView() const {
+		if (!IsString()) return {};
+		return std::string_view(_stringData(), _stringSize());
+	}
+
+	inline std::span<const Variant> GetVariantArrayView() const {
+		if (!IsVariantArray()) return {};
+		return _payload<std::vector<Variant>>();
+	}
+
+	inline std::span<const uint32_t> GetUInt32ArrayView() const {
+		return GetPackedArrayView<uint32_t>();
 	}
 
-	bool IsInt() inline const {
-		return (_currentType & (StoredType::Int32 | StoredType::UInt32 | StoredType::Int64 | StoredType::UInt64));
+	template <typename T> requires IsPackedElement<T>
+	std::span<const T> GetPackedArrayView() const {
+		if (_currentType() != PackedArrayType<T>()) return {};
+		return _payload<std::vector<T>>();
+	}
+
+	inline std::span<const uint8_t> GetPackedArrayBytes() const {
+		if (!IsPackedArray()) return {};
+		return _visitPackedArray([](const auto& array) {
+			return std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(array.data()), array.size() * sizeof(array[0]));
+		});
+	}
+
+	inline bool IsEmptyOrVoid() const {
+		return _currentType() & (StoredType::Void | StoredType::Empty);
+	}
+
+	inline bool IsInt() const {
+		return (_currentType() & (StoredType::Int32 | StoredType::UInt32 | StoredType::Int64 | StoredType::UInt64));
 	};
 
-	bool IsNumeric() inline const {
-		return (_currentType & (StoredType::Int32 | StoredType::UInt32 | StoredType::Int64 | StoredType::UInt64 | StoredType::Float | StoredType::Double));
+	inline bool IsNumeric() const {
+		return (_currentType() & (StoredType::Int32 | StoredType::UInt32 | StoredType::Int64 | StoredType::UInt64 | StoredType::Float | StoredType::Double));
 	};
 
-	bool IsSignedInt() inline const {
-		return (_currentType & (StoredType::Int32 | StoredType::Int64));
+	inline bool IsSignedInt() const {
+		return (_currentType() & (StoredType::Int32 | StoredType::Int64));
 	};
 
-	static char* BinarySerialise(Variant v);
-	static int32_t BinarySerialisationLength(char* bin);
-	static std::string StringSerialise(Variant v);
-	static Variant FromString(std::string* str);
+	static std::string StringSerialise(const Variant& v);
+	// Parses a value in the format written by StringSerialise. Returns an Empty Variant if the string is not valid.
+	static Variant FromString(std::string_view str);
 	
 	//// Operators and constructors
 
 	Variant() { 
-		_primitiveData._int = 0; 
-		_currentType = StoredType::Empty; 
+		_storage.held.typeByte = 0;
+		_storage.held.value._llong = 0;
 	};
 
 	Variant(StoredType type) {
-		_primitiveData._int = 0;
-		_currentType = type;
+		_storage.held.value._llong = 0;
+		_setType(type);
 	}
 
 	Variant(const Variant& other) {
-		_currentType = other._currentType;
-		switch (_currentType)
-		{
-			case Variant::Bool:
-			case Variant::Int32:
-			case Variant::UInt32:
-			case Variant::Int64:
-			case Variant::UInt64:
-			case Variant::Float:
-			case Variant::Double:
-				_primitiveData = other._primitiveData;
-				break;
-			case Variant::String:
-				_primitiveData._ptr = new string(*(string*)other._primitiveData._ptr);
-				break;
-			case Variant::VariantArray:
-				_primitiveData._ptr = new std::vector<Variant>(*(std::vector<Variant>*)other._primitiveData._ptr);
-				break;
-			case Variant::UInt32Array:
-				_primitiveData._ptr = new std::vector<uint32_t>(*(std::vector<uint32_t>*)other._primitiveData._ptr);
-				break;
-			default:
-				_primitiveData._int = 0;
-				break;
-		}
+		_copyFrom(other);
 	};
 
 	Variant& operator=(const Variant& other) {
 		if (this == &other) return *this;
-		_currentType = other._currentType;
-		switch (_currentType)
-		{
-			case Variant::Bool:
-			case Variant::Int32:
-			case Variant::UInt32:
-			case Variant::Int64:
-			case Variant::UInt64:
-			case Variant::Float:
-			case Variant::Double:
-				_primitiveData = other._primitiveData;
-				break;
-			case Variant::String:
-				_primitiveData._ptr = new string(*(string*)other._primitiveData._ptr);
-				break;
-			case Variant::VariantArray:
-				_primitiveData._ptr = new std::vector<Variant>(*(std::vector<Variant>*)other._primitiveData._ptr);
-				break;
-			case Variant::UInt32Array:
-				_primitiveData._ptr = new std::vector<uint32_t>(*(std::vector<uint32_t>*)other._primitiveData._ptr);
-				break;
-			default:
-				_primitiveData._int = 0;
-				break;
-		}
+		_release();
+		_copyFrom(other);
 		return *this;
 	}
 
 	Variant(Variant&& other) noexcept {
-		_primitiveData = other._primitiveData;
-		_currentType = other._currentType;
-		other._primitiveData._int = 0;
-		other._currentType = StoredType::Empty;
+		_storage = other._storage;
+		other._storage.held.typeByte = 0;
+		other._storage.held.value._llong = 0;
 	};
 
 
@@ -207,99 +504,99 @@ struct Variant {
 	Variant(A&& data) {
 		using T = std::decay_t<A>;
 		if constexpr (IsIntegerEnum<T>) {
-			_primitiveData._int = static_cast<int32_t>(data);
-			_currentType = StoredType::Int32;
+			_storage.held.value._int = static_cast<int32_t>(data);
+			_setType(StoredType::Int32);
 		}
 		else if constexpr (std::is_same_v<T, bool>) {
-			_currentType = StoredType::Bool;
-			_primitiveData._bool = data;
+			_setType(StoredType::Bool);
+			_storage.held.value._bool = data;
 		}
 		else if constexpr (std::is_same_v<T, int32_t>) {
-			_currentType = StoredType::Int32;
-			_primitiveData._int = data;
+			_setType(StoredType::Int32);
+			_storage.held.value._int = data;
 		}
 		else if constexpr (std::is_same_v<T, uint32_t>) {
-			_currentType = StoredType::UInt32;
-			_primitiveData._uint = data;
+			_setType(StoredType::UInt32);
+			_storage.held.value._uint = data;
 		}
 		else if constexpr (std::is_same_v<T, int64_t>) {
-			_currentType = StoredType::Int64;
-			_primitiveData._llong = data;
+			_setType(StoredType::Int64);
+			_storage.held.value._llong = data;
 		}
 		else if constexpr (std::is_same_v<T, uint64_t>) {
-			_currentType = StoredType::UInt64;
-			_primitiveData._ullong = data;
+			_setType(StoredType::UInt64);
+			_storage.held.value._ullong = data;
 
 		}
 		else if constexpr (std::is_same_v<T, float>) {
-			_currentType = StoredType::Float;
-			_primitiveData._float = data;
+			_setType(StoredType::Float);
+			_storage.held.value._float = data;
 		}
 		else if constexpr (std::is_same_v<T, double>) {
-			_currentType = StoredType::Double;
-			_primitiveData._double = data;
+			_setType(StoredType::Double);
+			_storage.held.value._double = data;
 		}
-		else if constexpr (std::is_same_v<T, const char*>) {
-			_currentType = StoredType::String;
-			_primitiveData._ptr = new string(data);
+		else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>) {
+			_setString(data, strlen(data));
+		}
+		else if constexpr (std::is_same_v<T, std::string_view>) {
+			_setString(data.data(), data.size());
 		}
 		else if constexpr (std::is_same_v<T, string>) {
-			_currentType = StoredType::String;
-			_primitiveData._ptr = new std::string(std::forward<T>(data));
+			if (data.size() <= SHORT_STRING_CAPACITY) {
+				_setString(data.data(), data.size());
+			}
+			else {
+				_setPayload<string>(StoredType::String, std::forward<A>(data));
+			}
 		}
 		else if constexpr (std::is_same_v<T, std::vector<Variant>>) {
-			_currentType = StoredType::VariantArray;
-			_primitiveData._ptr = new std::vector<Variant>(std::forward<T>(data));
+			_setPayload<std::vector<Variant>>(StoredType::VariantArray, std::forward<A>(data));
 		}
-		else if constexpr (std::is_same_v<T, std::vector<uint32_t>>) {
-			_currentType = StoredType::UInt32Array;
-			_primitiveData._ptr = new std::vector<uint32_t>(std::forward<T>(data));
+		else if constexpr (IsPackedVector<T>) {
+			_setPayload<T>(PackedArrayType<typename T::value_type>(), std::forward<A>(data));
 		}
 		else {
-			static_assert(false, "Invalid Variant constructor call");
+			// Dependent on T so that it only fires for a constructor call that is actually instantiated.
+			static_assert(sizeof(T) == 0, "Invalid Variant constructor call");
 		}
 	}
 
 	~Variant() {
-		switch (_currentType)
-		{
-			case Variant::String:
-			case Variant::VariantArray:
-			case Variant::UInt32Array:
-				delete _primitiveData._ptr;
-				break;
-			default:
-				break;
-		}
+		_release();
 	};
 
 	template<typename T>
 	operator T() const {
 		using U = std::decay_t<T>;
 		if constexpr (std::is_same_v<U, bool>) {
-			switch (_currentType) {
-				case StoredType::Bool: return _primitiveData._bool;
-				case StoredType::Int32: return _primitiveData._int != 0;
-				case StoredType::UInt32: return _primitiveData._uint != 0;
-				case StoredType::Int64: return _primitiveData._llong != 0;
-				case StoredType::UInt64: return _primitiveData._ullong != 0;
-				case StoredType::Float: return _primitiveData._float != 0.0f;
-				case StoredType::Double: return _primitiveData._double != 0.0;
+			switch (_currentType()) {
+				case StoredType::Bool: return _storage.held.value._bool;
+				case StoredType::Int32: return _storage.held.value._int != 0;
+				case StoredType::UInt32: return _storage.held.value._uint != 0;
+				case StoredType::Int64: return _storage.held.value._llong != 0;
+				case StoredType::UInt64: return _storage.held.value._ullong != 0;
+				case StoredType::Float: return _storage.held.value._float != 0.0f;
+				case StoredType::Double: return _storage.held.value._double != 0.0;
 				default: return false;
 			}
 		}
 		else if constexpr (std::is_arithmetic_v<U>) {
-			switch (_currentType) {
-				case StoredType::Bool: return static_cast<U>(_primitiveData._bool);
-				case StoredType::Int32: return static_cast<U>(_primitiveData._int);
-				case StoredType::UInt32: return static_cast<U>(_primitiveData._uint);
-				case StoredType::Int64: return static_cast<U>(_primitiveData._llong);
-				case StoredType::UInt64: return static_cast<U>(_primitiveData._ullong);
-				case StoredType::Float: return static_cast<U>(_primitiveData._float);
-				case StoredType::Double: return static_cast<U>(_primitiveData._double);
+			switch (_currentType()) {
+				case StoredType::Bool: return static_cast<U>(_storage.held.value._bool);
+				case StoredType::Int32: return static_cast<U>(_storage.held.value._int);
+				case StoredType::UInt32: return static_cast<U>(_storage.held.value._uint);
+				case StoredType::Int64: return static_cast<U>(_storage.held.value._llong);
+				case StoredType::UInt64: return static_cast<U>(_storage.held.value._ullong);
+				case StoredType::Float: return static_cast<U>(_storage.held.value._float);
+				case StoredType::Double: return static_cast<U>(_storage.held.value._double);
 				default: return U{};
 			}
 		}
+		else if constexpr (IsPackedVector<U>) {
+			std::span<const typename U::value_type> view = GetPackedArrayView<typename U::value_type>();
+			return U(view.begin(), view.end());
+		}
 		else {
 			return U{};
 		}
@@ -307,44 +604,35 @@ struct Variant {
 	}
 
 	operator std::string() const {
-		switch (_currentType) {
+		switch (_currentType()) {
 			case StoredType::Empty:
 			case StoredType::Void:
 				return "";
 			case StoredType::Bool:
-				return _primitiveData._bool ? "true" : "false";
+				return _storage.held.value._bool ? "true" : "false";
 			case StoredType::Int32:
-				return std::to_string(_primitiveData._int);
+				return std::to_string(_storage.held.value._int);
 			case StoredType::UInt32:
-				return std::to_string(_primitiveData._uint);
+				return std::to_string(_storage.held.value._uint);
 			case StoredType::Int64:
-				return std::to_string(_primitiveData._llong);
+				return std::to_string(_storage.held.value._llong);
 			case StoredType::UInt64:
-				return std::to_string(_primitiveData._ullong);
+				return std::to_string(_storage.held.value._ullong);
 			case StoredType::Float:
-				return std::to_string(_primitiveData._float);
+				return std::to_string(_storage.held.value._float);
 			case StoredType::Double:
-				return std::to_string(_primitiveData._double);
+				return std::to_string(_storage.held.value._double);
 			case StoredType::String:
-				return *(string*)_primitiveData._ptr;
+				return string(_stringData(), _stringSize());
 		}
 
 		return "";
 	};
 
 	operator std::vector<Variant>() const {
-		switch (_currentType) {
+		switch (_currentType()) {
 			case StoredType::VariantArray:
-				return *(std::vector<Variant>*)_primitiveData._ptr;
-			default:
-				return {};
-		}
-	}
-
-	operator std::vector<uint32_t>() const {
-		switch (_currentType) {
-			case StoredType::UInt32Array:
-				return *(std::vector<uint32_t>*)_primitiveData._ptr;
+				return _payload<std::vector<Variant>>();
 			default:
 				return {};
 		}
@@ -352,7 +640,7 @@ struct Variant {
 
 	template <typename E> requires IsIntegerEnum<E>
 	operator E() const noexcept {
-		return static_cast<E>(_primitiveData._int);
+		return static_cast<E>(_storage.held.value._int);
 	}
 
 	friend bool operator==(const Variant& lhs, const Variant& rhs) {
@@ -360,4 +648,7 @@ struct Variant {
 	};
 
 
-};
\ No newline at end of file
+};
+
+// Variants are stored in arrays and passed in RTTI argument slots, so their size matters.
+static_assert(sizeof(Variant) <= 16, "Variant should fit in 16 bytes");
@@ -1,6 +1,8 @@
 #include "engine_io.h"
 #include "core/types/object.h"
+#include "core/types/variant_stream.h"
 #include <external/md5.h>
+#include <cstring>
 using namespace resources;
 using namespace EngineIO;
 
@@ -11,141 +13,126 @@ string EngineIO::File::GetHash() {
 
 void EngineIO::ObjectSaver::SerialiseResourceBinary(Resource* res, std::string filepath)
 {
-	File outFile = EngineIO::FileSystem::OpenOrCreateFile(filepath, std::ios::binary | std::ios::out);
-	fstream* outStream = outFile.GetFileStream();
-	string className = res->_ClassName();
+	const string& className = res->_ClassName().String();
 	string resourceName = res->Name();
-	outStream->write(className.c_str(), className.size());
-	outStream->put(0x00);
-	outStream->write(resourceName.c_str(), resourceName.size());
-	outStream->put(0x00);
 
-	map<string, ObjectRTTIModel::ObjectPropertyDefinition> properties = res->_GetPropertyList();
-	map<string, ObjectRTTIModel::ObjectPropertyDefinition>::iterator it = properties.begin();
+	// The class's property handles are already resolved, so reading each value is a direct getter call.
+	engine_type_registry::EngineClass* cls = engine_type_registry::type_registry::find_class(res->_ClassName());
+	if (cls == nullptr) {
+		Log.Error("EngineIO", "Cannot serialise resource of unregistered class " + className);
+		return;
+	}
+	const vector<engine_type_registry::PropertyHandle>& properties = cls->GetProperties();
+
+	// Values are gathered first so the buffer can be sized once for the whole resource. Numeric data members are
+	// copied straight from the object when writing instead.
+	vector<Variant> values;
+	values.reserve(properties.size());
+	size_t size = BINARY_RESOURCE_HEADER_SIZE + className.size() + resourceName.size() + 2;
+	for (const engine_type_registry::PropertyHandle& property : properties) {
+		const engine_type_registry::ObjectMember* member = property.GetMember();
+		if (member != nullptr && member->isNumeric) {
+			values.push_back(Variant());
+			size += property.GetDefinition().propertyName.size() + 1 + VARIANT_ENUM_SIZE + member->size;
+			continue;
+		}
+		values.push_back(property.Get(res));
+		size += property.GetDefinition().propertyName.size() + 1 + VariantWriter::SerialisedSize(values.back());
+	}
 
-	while (it != properties.end()) {
-		outStream->write(it->first.c_str(), it->first.size());
-		outStream->put(0x00);
-		Variant value = res->_Call(it->second.getterName);
-		char* val = Variant::BinarySerialise(value);
-		outStream->write(val, Variant::BinarySerialisationLength(val));
-		delete val;
-		it++;
+	vector<uint8_t> buffer;
+	VariantWriter writer(buffer);
+	writer.Reserve(size);
+	writer.WriteBytes(BINARY_RESOURCE_MAGIC, sizeof(BINARY_RESOURCE_MAGIC));
+	writer.WriteBytes(&BINARY_RESOURCE_VERSION, sizeof(BINARY_RESOURCE_VERSION));
+	writer.WriteCString(className);
+	writer.WriteCString(resourceName);
+	for (size_t i = 0; i < properties.size(); i++) {
+		writer.WriteCString(properties[i].GetDefinition().propertyName);
+		const engine_type_registry::ObjectMember* member = properties[i].GetMember();
+		if (member != nullptr && member->isNumeric) {
+			writer.WriteNumeric(member->type, member->Address(res));
+		}
+		else {
+			writer.Write(values[i]);
+		}
 	}
 
+	File outFile = EngineIO::FileSystem::OpenOrCreateFile(filepath, std::ios::binary | std::ios::out);
+	outFile.GetFileStream()->write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
 }
 
 void EngineIO::ObjectSaver::SerialiseResourceText(Resource res, std::string filepath)
 {
 	fstream* outFile = (FileSystem::OpenOrCreateFile(filepath, std::ios::out).GetFileStream());
-	*outFile << "[" << res._ClassName() << "] " << res.Name()  << std::endl;
+	*outFile << "[" << res._ClassName().String() << "] " << res.Name()  << std::endl;
 
 	map<string, ObjectRTTIModel::ObjectPropertyDefinition> properties = res._GetPropertyList();
 	map<string, ObjectRTTIModel::ObjectPropertyDefinition>::iterator it = properties.begin();
 
 	while (it != properties.end()) {
-		Variant value = res._Call(it->second.getterName);
+		Variant value = res._Get(it->first);
 		*outFile << it->first << ": " << Variant::StringSerialise(value) << "" << std::endl;
 		it++;
 	}
 
 }
 
-Variant EngineIO::ObjectLoader::LoadBinaryVariant(File* input)
-{
-	fstream* inStream = input->GetFileStream();
-	short* typeBin = new short;
-	inStream->read((char*)typeBin, sizeof(short));
-	Variant::StoredType type = static_cast<Variant::StoredType>(*typeBin);
-	delete typeBin;
-
-	char valB = 0;
-	int32_t valInt = 0;
-	uint32_t valUInt = 0;
-	int64_t valLLong = 0;
-	uint64_t valULLong = 0;
-	float valFl = 0;
-	double valDb = 0;
-	int32_t strSize = 0;
-
-	switch (type) {
-		case Variant::Empty:
-		case Variant::Void:
-			return Variant(Variant::Void);
-		case Variant::Bool:
-			inStream->read(&valB, 1);
-			return valB == 0xFF;
-		case Variant::Int32:
-			inStream->read((char*)&valInt, sizeof(int32_t));
-			return valInt;
-		case Variant::UInt32:
-			inStream->read((char*)&valUInt, sizeof(uint32_t));
-			return valUInt;
-		case Variant::Int64:
-			inStream->read((char*)&valLLong, sizeof(int64_t));
-			return valLLong;
-		case Variant::UInt64:
-			inStream->read((char*)&valULLong, sizeof(uint64_t));
-			return valULLong;
-		case Variant::Float:
-			inStream->read((char*)&valFl, sizeof(float));
-			return valFl;
-		case Variant::Double:
-			inStream->read((char*)&valDb, sizeof(double));
-			return valDb;
-		case Variant::String:
-			inStream->read((char*)&strSize, sizeof(int32_t));
-			char* valStr = new char[strSize+1];
-			inStream->read(valStr, strSize);
-			valStr[strSize] = 0x00;
-			return std::string(valStr);
-	}
-	return Variant();
-}
-
 Resource* EngineIO::ObjectLoader::LoadSerialisedResourceBinary(std::string filepath)
 {
-	File file = EngineIO::FileSystem::OpenFile(filepath, std::ios::in | std::ios::binary);
-	fstream* inFile = file.GetFileStream();
-
-	if (!inFile->is_open()) {
+	if (!FileSystem::FileExists(filepath)) {
 		Log.Error("EngineIO", "Cannot load file " + filepath);
+		return nullptr;
 	}
+	File file = EngineIO::FileSystem::OpenFile(filepath, std::ios::in | std::ios::binary);
+	vector<uint8_t> data = file.ReadAllBinary();
 
-	std::string type;
-	std::string name;
-	
-	char ch;
-	while (inFile->read(&ch, 1)) {
-		if (ch == '\0') {
-			break;
-		}
-		type += ch; 
+	uint32_t version = 0;
+	if (data.size() >= BINARY_RESOURCE_HEADER_SIZE) memcpy(&version, data.data() + sizeof(BINARY_RESOURCE_MAGIC), sizeof(uint32_t));
+	if (data.size() < BINARY_RESOURCE_HEADER_SIZE || memcmp(data.data(), BINARY_RESOURCE_MAGIC, sizeof(BINARY_RESOURCE_MAGIC)) != 0 || version != BINARY_RESOURCE_VERSION) {
+		Log.Warn("EngineIO", "Resource file " + filepath + " was written in an older format");
+		return nullptr;
 	}
-	while (inFile->read(&ch, 1)) {
-		if (ch == '\0') {
-			break;
-		}
-		name += ch;
+	VariantReader reader(std::span<const uint8_t>(data).subspan(BINARY_RESOURCE_HEADER_SIZE));
+
+	StringName type = reader.ReadCString();
+	// The resource name, which is restored along with the other properties.
+	reader.ReadCString();
+	engine_type_registry::EngineClass* engCls = engine_type_registry::type_registry::find_class(type);
+	if (reader.Failed()) {
+		Log.Warn("EngineIO", "Corrupt resource file " + filepath);
+		return nullptr;
+	}
+	if (engCls == nullptr) {
+		Log.Error("EngineIO", "Cannot load file " + filepath + " - unknown resource type '" + type.String() + "'");
+		return nullptr;
 	}
 
-	engine_type_registry::EngineClass engCls = engine_type_registry::type_registry::_registered_classes[type];
-	Resource* res = dynamic_cast<Resource*>((*engCls._dynamic_constructor)());
-
-	std::string currentProp;
-	char* currentType = new char[VARIANT_ENUM_SIZE];
-	while (!inFile->eof()) {
-		while (inFile->read(&ch, 1)) {
-			if (ch == '\0') {
-				break;
-			}
-			currentProp += ch;
+	Object* obj = (*engCls->_dynamic_constructor)();
+	Resource* res = object_cast<Resource>(obj);
+	if (res == nullptr) {
+		// Log.Error throws, so the object has to be freed first.
+		delete obj;
+		Log.Error("EngineIO", "Cannot load file " + filepath + " - '" + type.String() + "' is not a resource type");
+		return nullptr;
+	}
+
+	while (!reader.AtEnd()) {
+		StringName currentProp = reader.ReadCString();
+		engine_type_registry::PropertyHandle property = engCls->ResolveProperty(currentProp);
+		const engine_type_registry::ObjectMember* member = property.IsValid() ? property.GetMember() : nullptr;
+		if (member != nullptr && member->isNumeric && !property.IsReadOnly() && reader.ReadNumeric(member->type, member->Address(res))) {
+			continue;
 		}
 
-		res->_Set(currentProp, LoadBinaryVariant(&file));
-		currentProp = "";
+		Variant value = reader.Read();
+		if (reader.Failed()) {
+			Log.Warn("EngineIO", "Corrupt resource file " + filepath);
+			delete res;
+			return nullptr;
+		}
+		if (property.IsValid()) property.Set(res, value);
 	}
-	delete[] currentType;
 	res->_Init();
 	return res;
 }
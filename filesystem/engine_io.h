@@ -92,6 +92,13 @@ namespace EngineIO {
 		}
 	};
 
+	// Every binary resource starts with this magic and format version. The version is raised whenever the binary format
+	// changes, so files written by an older engine are re-imported rather than misread.
+	constexpr char BINARY_RESOURCE_MAGIC[4] = { 'G', 'U', 'S', 'R' };
+	// Version 2: 4 byte type tags, packed arrays and Bool Saved.
+	constexpr uint32_t BINARY_RESOURCE_VERSION = 2;
+	constexpr size_t BINARY_RESOURCE_HEADER_SIZE = sizeof(BINARY_RESOURCE_MAGIC) + sizeof(uint32_t);
+
 	class ObjectSaver {
 		public:
 		static void SerialiseResourceBinary(Resource* res, std::string filepath);
@@ -99,9 +106,9 @@ namespace EngineIO {
 	};
 
 	class ObjectLoader {
-		private:
-		static Variant LoadBinaryVariant(File* input);
 		public:
+		// Returns nullptr without raising an error if the file was written in an older format or is corrupt, in which case
+		// the resource should be imported again.
 		static Resource* LoadSerialisedResourceBinary(std::string filepath);
 		static Resource* LoadSerialisedResourceText(std::string filepath);
 	};
@@ -5,6 +5,8 @@
 using namespace EngineIO;
 std::unordered_map<string, Resource*> ResourceLoader::loadedResources;
 std::unordered_map<string, ResourceLoader::ImportedResource> ResourceLoader::projectResources;
+std::map<uint32_t, std::function<void(Resource*)>> ResourceLoader::loadListeners;
+uint32_t ResourceLoader::nextListenerId = 0;
 
 void ResourceLoader::Init() {
     File resourceCache = FileSystem::OpenOrCreateFile(".gusengine/resources", std::ios::in);
@@ -59,6 +61,23 @@ void ResourceLoader::_updateCache(string hash, string filePath, Resource* res) {
     EngineIO::ObjectSaver::SerialiseResourceBinary(res, ".gusengine/" + newCache.hash);
 }
 
+uint32_t ResourceLoader::AddLoadListener(std::function<void(Resource*)> listener) {
+    uint32_t id = nextListenerId++;
+    loadListeners[id] = listener;
+    return id;
+}
+
+void ResourceLoader::RemoveLoadListener(uint32_t id) {
+    loadListeners.erase(id);
+}
+
+void ResourceLoader::_notifyLoaded(Resource* res) {
+    if (res == nullptr) return;
+    for (const auto& pair : loadListeners) {
+        pair.second(res);
+    }
+}
+
 bool ResourceLoader::IsResourceImported(string filePath) {
     return projectResources.contains(filePath);
 }
@@ -84,7 +103,13 @@ ResourceLoader::ImportResult ResourceLoader::ImportResource(string extResourcePa
     };
 
     if (std::find(supportedImageTypes.begin(), supportedImageTypes.end(), sourceType) != supportedImageTypes.end()) {
-        
+        // The decoded pixels are cached, so later loads read them back instead of decoding the source file again.
+        Image* image = Image::CreateFromFile(extResourcePath);
+        if (image == nullptr) return ImportResult::IMPORT_FAIL;
+        _updateCache(resHash, extResourcePath, image);
+        loadedResources[extResourcePath] = image;
+
+        return ImportResult::IMPORTED;
     }
 
     constexpr std::array supportedShaderTypes = {
@@ -124,13 +149,19 @@ Resource* ResourceLoader::_load(string filePath) {
     if (projectResources.contains(filePath) && !HasImportCacheChanged(filePath)) {
         Log.Debug("ResourceLoader", "Loading cached resource: " + filePath);
         Resource* r = ObjectLoader::LoadSerialisedResourceBinary(".gusengine/" + projectResources[filePath].hash);
-        loadedResources[filePath] = r;
-        return r;
+        if (r != nullptr) {
+            loadedResources[filePath] = r;
+            _notifyLoaded(r);
+            return r;
+        }
+        // The cached copy is outdated or corrupt, so the resource is imported again below, which rewrites it.
+        Log.Info("ResourceLoader", "Re-importing cached resource: " + filePath);
     }
     
     if (filePath.ends_with(".res")) {
         Resource* r = ObjectLoader::LoadSerialisedResourceText(filePath);
         loadedResources[filePath] = r;
+        _notifyLoaded(r);
         return r;
     }
     else {
@@ -143,6 +174,7 @@ Resource* ResourceLoader::_load(string filePath) {
 
         }
         else if (result == ImportResult::IMPORTED) {
+            _notifyLoaded(loadedResources[filePath]);
             return loadedResources[filePath];
         }
     }
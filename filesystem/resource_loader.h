@@ -2,6 +2,8 @@
 #include "core/globals.h"
 #include "core/types/resource.h"
 #include <unordered_map>
+#include <functional>
+#include <map>
 
 // Resource Types
 #include "project/resources/shader.h"
@@ -20,7 +22,11 @@ class ResourceLoader
 	static std::unordered_map<string, Resource*> loadedResources;
 	static std::unordered_map<string, ImportedResource> projectResources;
 	
+	static std::map<uint32_t, std::function<void(Resource*)>> loadListeners;
+	static uint32_t nextListenerId;
+
 	static void _updateCache(string hash, string filePath, Resource* res);
+	static void _notifyLoaded(Resource* res);
 	static Resource* _load(const string filePath);
 	public:
 	enum class ImportResult {
@@ -34,11 +40,16 @@ class ResourceLoader
 	static ImportResult ImportResource(string filePath);
 	static void Cleanup() {};
 
+	// Registers a function called with every resource the first time it is loaded, such as the renderer creating GPU
+	// objects for it. Returns an id for RemoveLoadListener.
+	static uint32_t AddLoadListener(std::function<void(Resource*)> listener);
+	static void RemoveLoadListener(uint32_t id);
+
 
 	template <typename T>
 	static T* Load(const string filePath) {
 		Resource* res = _load(filePath);
-		return dynamic_cast<T*>(res);
+		return object_cast<T>(res);
 	};
 	static Resource* Load(const string filePath) { return _load(filePath); }
 };
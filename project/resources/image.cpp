@@ -14,6 +14,17 @@ void Image::_register_type() {
 	using namespace ObjectRTTIModel;
 
 	type_registry::register_new_class("Image", "Resource");
+	type_registry::class_expose_method(ObjectMethodDefinition("GetFormat", Variant::StoredType::Int32), &Image::GetFormat);
+	type_registry::class_expose_method(ObjectMethodDefinition("GetWidth", Variant::StoredType::Int32), &Image::GetWidth);
+	type_registry::class_expose_method(ObjectMethodDefinition("GetHeight", Variant::StoredType::Int32), &Image::GetHeight);
+	type_registry::class_expose_method(ObjectMethodDefinition("GetChannels", Variant::StoredType::Int32), &Image::GetChannels);
+	type_registry::class_expose_method(ObjectMethodDefinition("GetPixelData", Variant::StoredType::ByteArray), &Image::GetPixelData);
+
+	type_registry::class_define_member_property("Format", ObjectPropertyDefinition::INTERNAL_SAVE, &Image::_format);
+	type_registry::class_define_member_property("Width", ObjectPropertyDefinition::INTERNAL_SAVE, &Image::_width);
+	type_registry::class_define_member_property("Height", ObjectPropertyDefinition::INTERNAL_SAVE, &Image::_height);
+	type_registry::class_define_member_property("Channels", ObjectPropertyDefinition::INTERNAL_SAVE, &Image::_channels);
+	type_registry::class_define_member_property("PixelData", ObjectPropertyDefinition::INTERNAL_SAVE, &Image::_pixelData);
 	type_registry::end_class();
 }
 
@@ -23,6 +23,7 @@ namespace resources {
 		vector<uint8_t> _pixelData {};
 		int32_t _width, _height, _channels = 0;
 		ImageFormat _format = ImageFormat::FORMAT_ERR;
+		uint32_t _bindlessIndex = UINT32_MAX;
 
 		public:
 
@@ -30,6 +31,10 @@ namespace resources {
 		int32_t GetWidth() inline const {return _width; };
 		int32_t GetHeight() inline const {return _height; };
 		int32_t GetChannels() inline const {return _channels; };
+		const vector<uint8_t>& GetPixelData() inline const {return _pixelData; };
+		// Index of the image in the renderer's bindless sampled image array, set once it has been uploaded.
+		uint32_t GetBindlessIndex() inline const {return _bindlessIndex; };
+		void SetBindlessIndex(uint32_t index) { _bindlessIndex = index; };
 		bool Is16Bit() inline const {
 			return (_format == ImageFormat::FORMAT_16L || _format == ImageFormat::FORMAT_16LA || _format == ImageFormat::FORMAT_16RGB || _format == ImageFormat::FORMAT_16RGBA);
 		}
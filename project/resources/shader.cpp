@@ -25,12 +25,11 @@ void resources::Shader::_register_type() {
 	type_registry::register_new_class("Shader", "Resource");
 	type_registry::class_expose_method(ObjectMethodDefinition("GetLanguage", Variant::StoredType::Int32), &Shader::GetLanguage);
 	type_registry::class_expose_method(ObjectMethodDefinition("GetStage", Variant::StoredType::Int32), &Shader::GetStage);
-	//type_registry::class_expose_method(ObjectMethodDefinition("GetShaderSPIRV", Variant::StoredType::UInt32), &Shader::GetShaderSPIRV);
+	type_registry::class_expose_method(ObjectMethodDefinition("GetShaderSPIRV", Variant::StoredType::UInt32Array), &Shader::GetShaderSPIRV);
 
-	ObjectRTTIModel::ObjectPropertyDefinition langProp = ObjectPropertyDefinition("Language", Variant::StoredType::Int32, ObjectPropertyDefinition::INTERNAL_SAVE, "GetLanguage");
-	ObjectRTTIModel::ObjectPropertyDefinition stageProp = ObjectPropertyDefinition("Stage", Variant::StoredType::Int32, ObjectPropertyDefinition::INTERNAL_SAVE, "GetStage");
-	type_registry::class_define_property(langProp);
-	type_registry::class_define_property(stageProp);
+	type_registry::class_define_member_property("Language", ObjectPropertyDefinition::INTERNAL_SAVE, &Shader::_lang);
+	type_registry::class_define_member_property("Stage", ObjectPropertyDefinition::INTERNAL_SAVE, &Shader::_stage);
+	type_registry::class_define_member_property("SPIRV", ObjectPropertyDefinition::INTERNAL_SAVE, &Shader::_spirvBinary);
 	type_registry::end_class();
 }
 
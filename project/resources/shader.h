@@ -33,7 +33,7 @@ namespace resources {
 
 		VkShaderModule GetShaderModule(VkDevice device);
 
-		vector<uint32_t> GetShaderSPIRV() const {
+		const vector<uint32_t>& GetShaderSPIRV() const {
 			return _spirvBinary;
 		}
 
@@ -0,0 +1,63 @@
+#include "threadPool.h"
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+	if (threadCount == 0) {
+		uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+	for (uint32_t i = 0; i < threadCount; i++)
+	{
+		_workers.emplace_back(&ThreadPool::workerLoop, this);
+	}
+}
+
+void ThreadPool::workerLoop()
+{
+	while (true) {
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_jobAvailable.wait(lock, [this] { return _stopping || !_jobs.empty(); });
+			if (_stopping && _jobs.empty()) return;
+			job = std::move(_jobs.front());
+			_jobs.pop();
+			_activeJobs++;
+		}
+
+		job();
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_activeJobs--;
+			if (_activeJobs == 0 && _jobs.empty()) _idle.notify_all();
+		}
+	}
+}
+
+void ThreadPool::Submit(std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_jobs.push(std::move(job));
+	}
+	_jobAvailable.notify_one();
+}
+
+void ThreadPool::WaitIdle()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_idle.wait(lock, [this] { return _activeJobs == 0 && _jobs.empty(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_jobAvailable.notify_all();
+	for (std::thread& worker : _workers) {
+		worker.join();
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <queue>
+#include <vector>
+#include <stdint.h>
+
+// A fixed size pool of worker threads that run submitted jobs in FIFO order.
+class ThreadPool {
+	private:
+	std::vector<std::thread> _workers;
+	std::queue<std::function<void()>> _jobs;
+	std::mutex _mutex;
+	std::condition_variable _jobAvailable;
+	std::condition_variable _idle;
+	uint32_t _activeJobs = 0;
+	bool _stopping = false;
+
+	void workerLoop();
+
+	public:
+	// A thread count of 0 uses one fewer than the number of hardware threads, leaving one for the main thread.
+	ThreadPool(uint32_t threadCount = 0);
+	uint32_t ThreadCount() const { return static_cast<uint32_t>(_workers.size()); }
+	void Submit(std::function<void()> job);
+	// Blocks until every submitted job has finished.
+	void WaitIdle();
+	~ThreadPool();
+};